@@ -0,0 +1,225 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class keeps downloaded album covers on disk between sessions, keyed by image url and
+ *        stored by the hash of their bytes, so a cover shared by many tracks is downloaded and kept once
+*/
+
+#include "ArtworkCache.h"
+#include "json.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <vector>
+#include <iostream>
+
+/** @brief Constructor for the ArtworkCache class, reads the index left by the previous session
+ * @param directory folder that holds the images and their index
+ * @param maxBytes total size of the images above which the least recently used ones are removed
+ */
+ArtworkCache::ArtworkCache(const QString& directory, qint64 maxBytes)
+    : directory(directory), maxBytes(maxBytes), totalBytes(0), clock(0), dirty(false),
+      hits(0), misses(0), duplicates(0), evictions(0) {
+    QDir().mkpath(directory);
+    load();
+}
+
+/** @brief Destructor, writes the index so the images are found again next session
+ */
+ArtworkCache::~ArtworkCache() {
+    save();
+}
+
+/** @brief builds the path of the file holding an image
+ * @param contentHash hash of the image bytes
+ * @return path of the file
+ */
+QString ArtworkCache::pathFor(const string& contentHash) const {
+    return directory + "/" + QString::fromStdString(contentHash) + ".img";
+}
+
+/** @brief reads the index, dropping entries whose file no longer exists, then adopts the images missing
+ *  from it, which were written after the index was last saved by a session that did not exit cleanly
+ */
+void ArtworkCache::load() {
+    QFile file(directory + "/index.json");
+    if (file.open(QIODevice::ReadOnly)) {
+        QByteArray data = file.readAll();
+        auto index = nlohmann::json::parse(data.constData(), data.constData() + data.size(), nullptr, false);
+        if (!index.is_discarded() && index.is_object()) {
+            loadIndex(index);
+        }
+    }
+
+    //no url leads to an adopted image, so it is counted against the limit and evicted first
+    for (const QFileInfo& info : QDir(directory).entryInfoList({"*.img"}, QDir::Files)) {
+        string contentHash = info.completeBaseName().toStdString();
+        if (blobs.count(contentHash)) {
+            continue;
+        }
+        Blob& blob = blobs[contentHash];
+        blob.size = info.size();
+        totalBytes += blob.size;
+        dirty = true;
+    }
+    evict();
+}
+
+/** @brief reads the blobs and urls of the index
+ * @param index the parsed index
+ */
+void ArtworkCache::loadIndex(const nlohmann::json& index) {
+    clock = index.value("clock", static_cast<uint64_t>(0));
+    nlohmann::json storedBlobs = index.value("blobs", nlohmann::json::object());
+    nlohmann::json storedUrls = index.value("urls", nlohmann::json::object());
+    for (const auto& entry : storedBlobs.items()) {
+        if (!QFile::exists(pathFor(entry.key()))) {
+            continue;
+        }
+        Blob& blob = blobs[entry.key()];
+        blob.size = entry.value().value("size", static_cast<qint64>(0));
+        blob.lastUsed = entry.value().value("lastUsed", static_cast<uint64_t>(0));
+        totalBytes += blob.size;
+    }
+    for (const auto& entry : storedUrls.items()) {
+        if (entry.value().is_string() && blobs.count(entry.value().get<string>())) {
+            urls[entry.key()] = entry.value().get<string>();
+        }
+    }
+}
+
+/** @brief writes the index if it changed since it was last written
+ */
+void ArtworkCache::save() {
+    lock_guard<mutex> lock(cacheMutex);
+    if (!dirty) {
+        return;
+    }
+    nlohmann::json index;
+    index["clock"] = clock;
+    index["blobs"] = nlohmann::json::object();
+    for (const auto& entry : blobs) {
+        index["blobs"][entry.first] = {{"size", entry.second.size}, {"lastUsed", entry.second.lastUsed}};
+    }
+    index["urls"] = urls;
+    string data = index.dump();
+
+    QFile file(directory + "/index.json");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        cerr << "Could not write artwork index: " << file.fileName().toStdString() << endl;
+        return;
+    }
+    file.write(data.data(), static_cast<qint64>(data.length()));
+    dirty = false;
+}
+
+/** @brief looks up the image downloaded from a url
+ * @param url the image url
+ * @return path of the stored image, empty if it has not been downloaded
+ */
+QString ArtworkCache::lookup(const string& url) {
+    lock_guard<mutex> lock(cacheMutex);
+    auto it = urls.find(url);
+    if (it == urls.end()) {
+        misses++;
+        return QString();
+    }
+    blobs[it->second].lastUsed = ++clock;
+    dirty = true;
+    hits++;
+    return pathFor(it->second);
+}
+
+/** @brief stores the image downloaded from a url, its bytes are written once however many urls share them
+ * @param url the image url
+ * @param data the image bytes as downloaded
+ * @return path of the stored image, empty if it could not be written
+ */
+QString ArtworkCache::store(const string& url, const QByteArray& data) {
+    string contentHash = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex().toStdString();
+
+    lock_guard<mutex> lock(cacheMutex);
+    auto existing = blobs.find(contentHash);
+    if (existing != blobs.end()) {
+        duplicates++;
+    }
+    else {
+        QFile file(pathFor(contentHash));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+            cerr << "Could not write artwork: " << file.fileName().toStdString() << endl;
+            return QString();
+        }
+        existing = blobs.emplace(contentHash, Blob()).first;
+        existing->second.size = data.size();
+        totalBytes += data.size();
+    }
+    existing->second.lastUsed = ++clock;
+    urls[url] = contentHash;
+    dirty = true;
+    evict();
+    return pathFor(contentHash);
+}
+
+/** @brief removes the least recently used images until the total size is within the limit,
+ *         the image used last is always kept
+ */
+void ArtworkCache::evict() {
+    while (totalBytes > maxBytes && blobs.size() > 1) {
+        auto oldest = blobs.begin();
+        for (auto it = blobs.begin(); it != blobs.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) {
+                oldest = it;
+            }
+        }
+        for (auto it = urls.begin(); it != urls.end();) {
+            it = (it->second == oldest->first) ? urls.erase(it) : next(it);
+        }
+        QFile::remove(pathFor(oldest->first));
+        totalBytes -= oldest->second.size;
+        blobs.erase(oldest);
+        evictions++;
+    }
+}
+
+/** @brief getter method for the number of lookups served from disk
+ * @return hits
+ */
+size_t ArtworkCache::getHits() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return hits;
+}
+
+/** @brief getter method for the number of lookups that had to be downloaded
+ * @return misses
+ */
+size_t ArtworkCache::getMisses() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return misses;
+}
+
+/** @brief getter method for the number of downloads identical to an image already stored
+ * @return duplicates
+ */
+size_t ArtworkCache::getDuplicates() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return duplicates;
+}
+
+/** @brief getter method for the number of images removed to stay within the size limit
+ * @return evictions
+ */
+size_t ArtworkCache::getEvictions() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return evictions;
+}
+
+/** @brief builds a one line summary of the cache counters
+ * @return the summary
+ */
+string ArtworkCache::getStatsReport() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return "Artwork cache: " + to_string(hits) + " hits, " + to_string(misses) + " misses, " +
+           to_string(duplicates) + " duplicates, " + to_string(evictions) + " evictions, " +
+           to_string(blobs.size()) + " images using " + to_string(totalBytes / 1024) + " KiB";
+}
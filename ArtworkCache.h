@@ -0,0 +1,64 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the ArtworkCache class
+*/
+#ifndef ARTWORKCACHE_H
+#define ARTWORKCACHE_H
+//include necessary libraries
+#include <string>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <QString>
+#include <QByteArray>
+#include "json.hpp"
+
+using namespace std;
+
+class ArtworkCache {
+public:
+    //initialize public functions to be used in ArtworkCache.cpp
+    explicit ArtworkCache(const QString& directory, qint64 maxBytes = 64 * 1024 * 1024);
+    ~ArtworkCache();
+    ArtworkCache(const ArtworkCache&) = delete;
+    ArtworkCache& operator=(const ArtworkCache&) = delete;
+
+    QString lookup(const string& url);
+    QString store(const string& url, const QByteArray& data);
+    void save();
+
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getDuplicates() const;
+    size_t getEvictions() const;
+    string getStatsReport() const;
+
+private:
+    //one image file, shared by every url whose download had the same bytes
+    struct Blob {
+        qint64 size = 0;
+        uint64_t lastUsed = 0; //value of the clock at the last access, for LRU eviction
+    };
+
+    QString directory;
+    qint64 maxBytes;
+    qint64 totalBytes;
+    uint64_t clock; //increases on every access, gives the recency of each blob
+    map<string, string> urls; //image url to the content hash of its bytes
+    map<string, Blob> blobs; //content hash to the file holding those bytes
+    bool dirty; //the index changed since it was last saved
+    mutable mutex cacheMutex;
+
+    size_t hits;
+    size_t misses;
+    size_t duplicates; //downloads whose bytes were already stored under another url
+    size_t evictions;
+
+    QString pathFor(const string& contentHash) const;
+    void load();
+    void loadIndex(const nlohmann::json& index);
+    void evict();
+};
+
+#endif // ARTWORKCACHE_H
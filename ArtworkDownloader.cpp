@@ -0,0 +1,252 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class downloads album covers in the background through one shared network manager,
+ *        a limited number at a time and in priority order, scales each one down to a thumbnail on a
+ *        worker thread and signals the thumbnail once it is ready
+*/
+
+#include "ArtworkDownloader.h"
+#include <QTimer>
+#include <QUrl>
+#include <QFile>
+#include <QBuffer>
+#include <QRunnable>
+#include <QElapsedTimer>
+#include <QPixmapCache>
+#include <functional>
+
+namespace {
+//runs a function on a thread pool
+class Job : public QRunnable {
+public:
+    explicit Job(function<void()> work) : work(move(work)) {}
+    void run() override { work(); }
+private:
+    function<void()> work;
+};
+}
+
+/** @brief Constructor for the ArtworkDownloader class
+ * @param cacheDirectory folder of the artwork cache the thumbnails are stored in
+ * @param thumbnailSize width and height in pixels the covers are scaled down to fit
+ * @param maxConcurrent maximum number of covers downloaded at the same time
+ * @param memoryBudgetKiB size of the process wide pixmap cache the decoded thumbnails are kept in
+ * @param parent owner of the downloader
+ */
+ArtworkDownloader::ArtworkDownloader(const QString& cacheDirectory, int thumbnailSize, int maxConcurrent, int memoryBudgetKiB,
+                                     QObject* parent)
+    : QObject(parent), cache(cacheDirectory), manager(new QNetworkAccessManager(this)), thumbnailSize(thumbnailSize),
+      maxConcurrent(maxConcurrent < 1 ? 1 : maxConcurrent), nextOrder(0),
+      downloaded(0), cancelled(0), failed(0), bytesDownloaded(0), memoryHits(0), thumbnailsMade(0), thumbnailMs(0) {
+    workers.setMaxThreadCount(2);
+    //restarted by every store, so a burst of downloads writes the index once
+    saveTimer = new QTimer(this);
+    saveTimer->setSingleShot(true);
+    saveTimer->setInterval(2000);
+    connect(saveTimer, &QTimer::timeout, this, [this]() { cache.save(); });
+    //least recently used pixmaps are dropped once the budget is reached, they are decoded again from disk
+    QPixmapCache::setCacheLimit(memoryBudgetKiB);
+}
+
+/** @brief Destructor, waits for the workers since their results are posted back to this object
+ */
+ArtworkDownloader::~ArtworkDownloader() {
+    workers.clear();
+    workers.waitForDone();
+}
+
+/** @brief builds the key of a decoded cover in the pixmap cache
+ * @param imageUrl url of the cover
+ * @return the key
+ */
+QString ArtworkDownloader::pixmapKey(const string& imageUrl) {
+    return "artwork:" + QString::fromStdString(imageUrl);
+}
+
+/** @brief asks for a cover, it is served from the cache at once or queued for download
+ *  Asking again for a queued cover with a higher priority moves it forward in the queue.
+ * @param imageUrl url of the cover
+ * @param priority how urgently the cover is needed
+ */
+void ArtworkDownloader::request(const string& imageUrl, Priority priority) {
+    if (imageUrl.empty() || inFlight.count(imageUrl) || preparing.count(imageUrl)) {
+        return;
+    }
+    QPixmap decoded;
+    if (QPixmapCache::find(pixmapKey(imageUrl), &decoded)) {
+        memoryHits++;
+        emit artworkReady(QString::fromStdString(imageUrl), decoded);
+        return;
+    }
+    auto waiting = queued.find(imageUrl);
+    if (waiting != queued.end()) {
+        if (priority < waiting->second.first) {
+            queue.erase(make_tuple(waiting->second.first, waiting->second.second, imageUrl));
+            waiting->second.first = priority;
+            queue.insert(make_tuple(priority, waiting->second.second, imageUrl));
+        }
+        return;
+    }
+
+    //a thumbnail stored by an earlier session is read and decoded by a worker
+    QString path = cache.lookup(imageUrl);
+    if (!path.isEmpty()) {
+        preparing.insert(imageUrl);
+        workers.start(new Job([this, imageUrl, path]() {
+            QFile file(path);
+            prepare(imageUrl, file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray(), false);
+        }));
+        return;
+    }
+    uint64_t order = nextOrder++;
+    queued[imageUrl] = make_pair(priority, order);
+    queue.insert(make_tuple(priority, order, imageUrl));
+    startNext();
+}
+
+/** @brief drops a cover that is no longer needed, aborting its download if it has started
+ * @param imageUrl url of the cover
+ */
+void ArtworkDownloader::cancel(const string& imageUrl) {
+    auto waiting = queued.find(imageUrl);
+    if (waiting != queued.end()) {
+        queue.erase(make_tuple(waiting->second.first, waiting->second.second, imageUrl));
+        queued.erase(waiting);
+        cancelled++;
+        return;
+    }
+    auto running = inFlight.find(imageUrl);
+    if (running != inFlight.end()) {
+        QNetworkReply* reply = running->second;
+        inFlight.erase(running);
+        //disconnected first so the abort does not report a failure
+        QObject::disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+        cancelled++;
+        //started later so that a caller cancelling several covers does not start the next ones in between
+        QTimer::singleShot(0, this, [this]() { startNext(); });
+    }
+}
+
+/** @brief starts queued downloads until the concurrency limit is reached
+ */
+void ArtworkDownloader::startNext() {
+    while (static_cast<int>(inFlight.size()) < maxConcurrent && !queue.empty()) {
+        string imageUrl = get<2>(*queue.begin());
+        queue.erase(queue.begin());
+        queued.erase(imageUrl);
+
+        QNetworkReply* reply = manager->get(QNetworkRequest(QUrl(QString::fromStdString(imageUrl))));
+        inFlight[imageUrl] = reply;
+        connect(reply, &QNetworkReply::finished, this, [this, imageUrl, reply]() { finished(imageUrl, reply); });
+    }
+}
+
+/** @brief stores a finished download and signals it, then starts the next one
+ * @param imageUrl url of the cover
+ * @param reply the finished reply
+ */
+void ArtworkDownloader::finished(const string& imageUrl, QNetworkReply* reply) {
+    inFlight.erase(imageUrl);
+    if (reply->error() == QNetworkReply::NoError) {
+        QByteArray data = reply->readAll();
+        bytesDownloaded += data.size();
+        downloaded++;
+        preparing.insert(imageUrl);
+        workers.start(new Job([this, imageUrl, data]() { prepare(imageUrl, data, true); }));
+    }
+    else {
+        failed++;
+        //qWarning() << "Failed to download image:" << reply->errorString();
+    }
+    reply->deleteLater();
+    startNext();
+}
+
+/** @brief decodes a cover and scales it down to the thumbnail size, runs on a worker thread
+ *  A downloaded cover is stored in the cache as the encoded thumbnail, so later sessions read the small image.
+ * @param imageUrl url of the cover
+ * @param data the encoded image
+ * @param downloaded true for a new download, false for a thumbnail read from the cache
+ */
+void ArtworkDownloader::prepare(const string& imageUrl, const QByteArray& data, bool downloaded) {
+    QElapsedTimer timer;
+    timer.start();
+    QImage image = QImage::fromData(data);
+    bool made = false;
+    bool stored = false;
+    if (!image.isNull() && (image.width() > thumbnailSize || image.height() > thumbnailSize)) {
+        image = image.scaled(thumbnailSize, thumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        made = true;
+    }
+    if (!image.isNull() && downloaded) {
+        QByteArray encoded;
+        QBuffer buffer(&encoded);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "JPG", 90);
+        stored = !cache.store(imageUrl, encoded).isEmpty();
+    }
+    qint64 ms = timer.elapsed();
+    QMetaObject::invokeMethod(this, [this, imageUrl, image, ms, made, stored]() { prepared(imageUrl, image, ms, made, stored); },
+                              Qt::QueuedConnection);
+}
+
+/** @brief converts a decoded thumbnail to a pixmap, keeps it in the pixmap cache and signals it,
+ *         runs on the GUI thread since pixmaps can only be created there
+ * @param imageUrl url of the cover
+ * @param thumbnail the decoded thumbnail, null if the cover could not be decoded
+ * @param ms time the worker spent on it
+ * @param made true if the cover had to be scaled down
+ * @param stored true if the thumbnail was added to the cache, its index is then saved once the downloads settle
+ */
+void ArtworkDownloader::prepared(const string& imageUrl, const QImage& thumbnail, qint64 ms, bool made, bool stored) {
+    preparing.erase(imageUrl);
+    if (stored) {
+        saveTimer->start();
+    }
+    thumbnailMs += ms;
+    if (made) {
+        thumbnailsMade++;
+    }
+    if (thumbnail.isNull()) {
+        failed++;
+        return;
+    }
+    QPixmap pixmap = QPixmap::fromImage(thumbnail);
+    QPixmapCache::insert(pixmapKey(imageUrl), pixmap);
+    emit artworkReady(QString::fromStdString(imageUrl), pixmap);
+}
+
+/** @brief setter method for the concurrency limit
+ * @param maxConcurrent maximum number of covers downloaded at the same time
+ */
+void ArtworkDownloader::setMaxConcurrent(int maxConcurrent) {
+    this->maxConcurrent = maxConcurrent < 1 ? 1 : maxConcurrent;
+    startNext();
+}
+
+/** @brief getter method for the concurrency limit
+ * @return maxConcurrent
+ */
+int ArtworkDownloader::getMaxConcurrent() const {
+    return maxConcurrent;
+}
+
+/** @brief getter method for the thumbnail size
+ * @return thumbnailSize
+ */
+int ArtworkDownloader::getThumbnailSize() const {
+    return thumbnailSize;
+}
+
+/** @brief builds a summary of the download counters and of the cache behind them
+ * @return the summary
+ */
+string ArtworkDownloader::getStatsReport() const {
+    return "Artwork downloads: " + to_string(downloaded) + " downloaded (" + to_string(bytesDownloaded / 1024) +
+           " KiB), " + to_string(memoryHits) + " served from memory, " + to_string(cancelled) + " cancelled, " +
+           to_string(failed) + " failed, " + to_string(thumbnailsMade) + " scaled to " + to_string(thumbnailSize) +
+           "px in " + to_string(thumbnailMs) + " ms\n" + cache.getStatsReport();
+}
@@ -0,0 +1,82 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables, methods and signals of the ArtworkDownloader class
+*/
+#ifndef ARTWORKDOWNLOADER_H
+#define ARTWORKDOWNLOADER_H
+//include necessary libraries
+#include <string>
+#include <map>
+#include <set>
+#include <tuple>
+#include <cstdint>
+#include <QObject>
+#include <QString>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QImage>
+#include <QPixmap>
+#include <QThreadPool>
+#include <QTimer>
+#include "ArtworkCache.h"
+
+using namespace std;
+
+class ArtworkDownloader : public QObject {
+    Q_OBJECT
+
+public:
+    //order in which queued covers are downloaded, lower first
+    enum Priority {
+        NowPlaying, //the cover of the current track
+        Visible,    //rows on screen
+        Nearby      //rows within a screen of the visible ones, fetched ahead of scrolling
+    };
+
+    //initialize public functions to be used in ArtworkDownloader.cpp
+    explicit ArtworkDownloader(const QString& cacheDirectory, int thumbnailSize = 100, int maxConcurrent = 4,
+                               int memoryBudgetKiB = 8 * 1024, QObject* parent = nullptr);
+    ~ArtworkDownloader();
+
+    void request(const string& imageUrl, Priority priority);
+    void cancel(const string& imageUrl);
+    void setMaxConcurrent(int maxConcurrent);
+    int getMaxConcurrent() const;
+    int getThumbnailSize() const;
+    string getStatsReport() const;
+
+signals:
+    //emitted once per request with the cover scaled to the thumbnail size, also when it was already cached
+    void artworkReady(const QString& imageUrl, const QPixmap& thumbnail);
+
+private:
+    ArtworkCache cache; //holds the thumbnails, not the downloaded covers
+    QTimer* saveTimer; //saves the index of the cache shortly after it changes, not only on exit
+    QNetworkAccessManager* manager; //one manager, and so one connection pool, for every cover
+    QThreadPool workers; //decodes and scales covers off the GUI thread
+    int thumbnailSize;
+    int maxConcurrent;
+    uint64_t nextOrder; //requests of the same priority are started in the order they were made
+    set<tuple<Priority, uint64_t, string>> queue;
+    map<string, pair<Priority, uint64_t>> queued; //url to its key in the queue
+    map<string, QNetworkReply*> inFlight;
+    set<string> preparing; //covers being decoded by a worker
+
+    size_t downloaded;
+    size_t cancelled;
+    size_t failed;
+    qint64 bytesDownloaded;
+    size_t memoryHits; //requests served by an already decoded pixmap
+    size_t thumbnailsMade;
+    qint64 thumbnailMs; //time the workers spent decoding, scaling and encoding
+
+    static QString pixmapKey(const string& imageUrl);
+    void startNext();
+    void finished(const string& imageUrl, QNetworkReply* reply);
+    void prepare(const string& imageUrl, const QByteArray& data, bool downloaded);
+    void prepared(const string& imageUrl, const QImage& thumbnail, qint64 ms, bool made, bool stored);
+};
+
+#endif // ARTWORKDOWNLOADER_H
@@ -0,0 +1,139 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class is a minimal HTTP listener for the redirect URI. The accounts service sends the
+ *        browser back to http://localhost:<port>/?code=...&state=..., the listener answers the page
+ *        and hands the code over so the exchange can start straight away
+*/
+
+#include "AuthorizationListener.h"
+#include <QHostAddress>
+#include <QUrl>
+#include <QUrlQuery>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+
+/** @brief Constructor for the AuthorizationListener class, picks a new state value
+ * @param port port of the redirect URI registered for the app
+ * @param parent owner of the listener
+ */
+AuthorizationListener::AuthorizationListener(quint16 port, QObject* parent)
+    : QObject(parent), port(port) {
+    random_device random;
+    ostringstream value;
+    for (int i = 0; i < 4; i++) {
+        value << hex << setw(8) << setfill('0') << random();
+    }
+    state = value.str();
+    connect(&server, &QTcpServer::newConnection, this, [this]() { acceptConnection(&server); });
+    connect(&serverIPv6, &QTcpServer::newConnection, this, [this]() { acceptConnection(&serverIPv6); });
+}
+
+/** @brief starts listening on the IPv4 and IPv6 loopback addresses only, the browser may resolve
+ *  localhost to either of them
+ * @return false if neither can listen, the code then has to be pasted
+ */
+bool AuthorizationListener::listen() {
+    bool listening = server.listen(QHostAddress::LocalHost, port);
+    if (!listening) {
+        cerr << "Could not listen for the authorization redirect: " << server.errorString().toStdString() << endl;
+    }
+    //a host without IPv6 only has the IPv4 listener
+    if (serverIPv6.listen(QHostAddress::LocalHostIPv6, port)) {
+        listening = true;
+    }
+    else {
+        cerr << "Could not listen for the authorization redirect on IPv6: " << serverIPv6.errorString().toStdString() << endl;
+    }
+    return listening;
+}
+
+/** @brief stops listening, connections already accepted are still answered
+ */
+void AuthorizationListener::close() {
+    server.close();
+    serverIPv6.close();
+}
+
+/** @brief getter method for the redirect URI to send with the authorize request
+ * @return the redirect URI
+ */
+string AuthorizationListener::getRedirectUri() const {
+    return "http://localhost:" + to_string(port);
+}
+
+/** @brief getter method for the state to send with the authorize request
+ * @return state
+ */
+string AuthorizationListener::getState() const {
+    return state;
+}
+
+/** @brief reads the request line of every new connection and answers it
+ * @param listening the server the connections arrived on
+ */
+void AuthorizationListener::acceptConnection(QTcpServer* listening) {
+    while (QTcpSocket* socket = listening->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            //only the request line is needed, the rest of the request is ignored
+            QByteArray received = socket->peek(maxRequestBytes);
+            int end = received.indexOf("\r\n");
+            if (end < 0 && received.size() < maxRequestBytes) {
+                return;
+            }
+            socket->readAll();
+            disconnect(socket, &QTcpSocket::readyRead, this, nullptr);
+            answer(socket, end < 0 ? QByteArray() : received.left(end));
+        });
+    }
+}
+
+/** @brief answers one request, a redirect with a code and the expected state completes the listener
+ * @param socket the connection
+ * @param request the request line, such as "GET /?code=...&state=... HTTP/1.1"
+ */
+void AuthorizationListener::answer(QTcpSocket* socket, const QByteArray& request) {
+    QList<QByteArray> parts = request.split(' ');
+    if (parts.size() < 3 || parts[0] != "GET") {
+        reply(socket, "400 Bad Request", "Bad request.");
+        return;
+    }
+    QUrlQuery query(QUrl("http://localhost" + QString::fromLatin1(parts[1])));
+    if (!query.hasQueryItem("code") && !query.hasQueryItem("error")) {
+        //the browser also asks for things like the favicon
+        reply(socket, "404 Not Found", "Not found.");
+        return;
+    }
+    if (query.queryItemValue("state").toStdString() != state) {
+        reply(socket, "400 Bad Request", "This authorization was not started by this app.");
+        return;
+    }
+    if (query.hasQueryItem("error")) {
+        QString error = query.queryItemValue("error");
+        reply(socket, "200 OK", "Authorization failed: " + error + ". You can close this tab.");
+        close();
+        emit authorizationFailed(error);
+        return;
+    }
+    reply(socket, "200 OK", "Spotify Controller is authorized. You can close this tab.");
+    close();
+    emit codeReceived(query.queryItemValue("code", QUrl::FullyDecoded));
+}
+
+/** @brief writes a small HTML page and closes the connection once it is sent
+ * @param socket the connection
+ * @param status status line of the response
+ * @param message text of the page
+ */
+void AuthorizationListener::reply(QTcpSocket* socket, const char* status, const QString& message) {
+    QByteArray body = "<!DOCTYPE html><html><body><p>" + message.toHtmlEscaped().toUtf8() + "</p></body></html>";
+    QByteArray response = QByteArray("HTTP/1.1 ") + status + "\r\n"
+                          "Content-Type: text/html; charset=utf-8\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n" + body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,50 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables, methods and signals of the AuthorizationListener class
+*/
+#ifndef AUTHORIZATIONLISTENER_H
+#define AUTHORIZATIONLISTENER_H
+//include necessary libraries
+#include <string>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+using namespace std;
+
+//answers the OAuth redirect on localhost so the authorization code arrives without being pasted
+class AuthorizationListener : public QObject {
+    Q_OBJECT
+
+public:
+    //initialize public functions to be used in AuthorizationListener.cpp
+    explicit AuthorizationListener(quint16 port = 3000, QObject* parent = nullptr);
+
+    bool listen();
+    void close();
+    string getRedirectUri() const;
+    string getState() const;
+
+signals:
+    //the browser was redirected back with a code, to be exchanged for a token
+    void codeReceived(const QString& code);
+    //the user denied access or the request was rejected
+    void authorizationFailed(const QString& error);
+
+private:
+    QTcpServer server; //127.0.0.1
+    QTcpServer serverIPv6; //::1, localhost may resolve to either
+    quint16 port;
+    string state; //random value sent with the authorize request, the redirect must carry it back
+
+    static constexpr int maxRequestBytes = 8192;
+
+    void acceptConnection(QTcpServer* listening);
+    void answer(QTcpSocket* socket, const QByteArray& request);
+    static void reply(QTcpSocket* socket, const char* status, const QString& message);
+};
+
+#endif // AUTHORIZATIONLISTENER_H
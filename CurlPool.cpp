@@ -0,0 +1,277 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class keeps curl easy handles alive between requests so connections, DNS lookups
+ *        and TLS sessions to the Spotify hosts are reused instead of being rebuilt for every call
+*/
+
+#include "CurlPool.h"
+#include <sstream>
+#include <iomanip>
+#include <strings.h>
+#include <cstdlib>
+
+/** @brief Constructor for the CurlPool class
+ * @param maxPerHost is the maximum number of handles that may be checked out for one host at a time
+ */
+CurlPool::CurlPool(size_t maxPerHost)
+    : maxPerHost(maxPerHost == 0 ? 1 : maxPerHost), requestCount(0), reusedCount(0), bytesReceived(0) {
+    //curl_global_init is not thread safe, so it is done exactly once for the whole process
+    static once_flag globalInit;
+    call_once(globalInit, [] { curl_global_init(CURL_GLOBAL_ALL); });
+
+    share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShared);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShared);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    //the connection cache is not shared, libcurl does not support using a shared one from several threads
+    //at once; a pooled handle keeps its own connections and the request engine's multi handle keeps its own
+}
+
+/** @brief Destructor, cleans up every pooled handle before the share handle
+ */
+CurlPool::~CurlPool() {
+    for (auto& entry : hosts) {
+        for (CURL* handle : entry.second.idle) {
+            curl_easy_cleanup(handle);
+        }
+    }
+    for (auto& entry : checkedOut) {
+        curl_easy_cleanup(entry.first);
+    }
+    curl_share_cleanup(share);
+}
+
+/** @brief Calculates the total size of the data passed in
+ * @param contents is a pointer to the data that has been received
+ * @param size is the size of each data element
+ * @param nmemb is the number of elements
+ * @param data is a pointer to a string where the received data will be stored
+ * @return Total size of the data received
+ */
+size_t CurlPool::WriteCallback(void *contents, size_t size, size_t nmemb, string *data) {
+    size_t totalSize = size * nmemb;
+    data->append(static_cast<char*>(contents), totalSize);
+    return totalSize;
+}
+
+/** @brief reads the response headers that the callers need, the ETag and Retry-After
+ * @param buffer one header line, not null terminated
+ * @param size always 1
+ * @param nitems length of the line
+ * @param response the response the header belongs to
+ * @return number of bytes handled
+ */
+size_t CurlPool::HeaderCallback(char* buffer, size_t size, size_t nitems, HttpResponse* response) {
+    size_t totalSize = size * nitems;
+    string line(buffer, totalSize);
+    string name = "etag:";
+    if (line.length() > name.length() && strncasecmp(line.c_str(), name.c_str(), name.length()) == 0) {
+        size_t start = line.find_first_not_of(" \t", name.length());
+        size_t end = line.find_last_not_of(" \t\r\n");
+        if (start != string::npos && end != string::npos && end >= start) {
+            response->etag = line.substr(start, end - start + 1);
+        }
+    }
+    name = "retry-after:";
+    if (line.length() > name.length() && strncasecmp(line.c_str(), name.c_str(), name.length()) == 0) {
+        //spotify sends a number of seconds, the HTTP date form is not used
+        response->retryAfterSeconds = atoi(line.c_str() + name.length());
+    }
+    return totalSize;
+}
+
+/** @brief lock callback handed to the curl share interface
+ */
+void CurlPool::lockShared(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<CurlPool*>(userptr)->shareLocks[data].lock();
+}
+
+/** @brief unlock callback handed to the curl share interface
+ */
+void CurlPool::unlockShared(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<CurlPool*>(userptr)->shareLocks[data].unlock();
+}
+
+/** @brief extracts the host name from a url, used as the pool key
+ * @param url the full request url
+ * @return the host part of the url
+ */
+string CurlPool::hostOf(const string& url) {
+    auto start = url.find("://");
+    start = (start == string::npos) ? 0 : start + 3;
+    auto end = url.find_first_of("/?:", start);
+    if (end == string::npos) {
+        end = url.length();
+    }
+    return url.substr(start, end - start);
+}
+
+/** @brief checks out a handle for the host of the given url, waiting if the host is at its limit
+ * @param url the url that the handle will be used for
+ * @return a handle ready to be configured
+ */
+CURL* CurlPool::acquire(const string& url) {
+    string host = hostOf(url);
+    unique_lock<mutex> lock(poolMutex);
+    HostSlot& slot = hosts[host];
+    handleReleased.wait(lock, [&] { return slot.active < maxPerHost; });
+
+    CURL* handle;
+    if (!slot.idle.empty()) {
+        handle = slot.idle.back();
+        slot.idle.pop_back();
+    }
+    else {
+        handle = curl_easy_init();
+    }
+    slot.active++;
+    checkedOut[handle] = host;
+    return handle;
+}
+
+/** @brief returns a handle to the pool, its connection stays open for the next request
+ * @param handle the handle previously returned by acquire
+ */
+void CurlPool::release(CURL* handle) {
+    if (!handle) {
+        return;
+    }
+    //reset clears the options but keeps the live connection and session caches
+    curl_easy_reset(handle);
+
+    lock_guard<mutex> lock(poolMutex);
+    auto it = checkedOut.find(handle);
+    if (it == checkedOut.end()) {
+        curl_easy_cleanup(handle);
+        return;
+    }
+    HostSlot& slot = hosts[it->second];
+    slot.active--;
+    slot.idle.push_back(handle);
+    checkedOut.erase(it);
+    handleReleased.notify_all();
+}
+
+/** @brief applies a request to a handle
+ * @param handle the handle to configure
+ * @param request the request to send
+ * @param response where the body will be written
+ * @param headers receives the header list, which the caller must free after the transfer
+ */
+void CurlPool::configure(CURL* handle, const HttpRequest& request, HttpResponse* response, curl_slist** headers) {
+    *headers = nullptr;
+    for (const auto& header : request.headers) {
+        *headers = curl_slist_append(*headers, header.c_str());
+    }
+
+    curl_easy_setopt(handle, CURLOPT_SHARE, share);
+    curl_easy_setopt(handle, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, *headers);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response->body);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, response);
+
+    if (request.method == "POST") {
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body.c_str());
+    }
+    else if (request.method != "GET") {
+        curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+        if (!request.body.empty()) {
+            curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body.c_str());
+        }
+    }
+}
+
+/** @brief fills in the status and timing of a successful transfer and updates the counters
+ * @param handle the handle that just finished a transfer
+ * @param response the response of the transfer
+ */
+void CurlPool::complete(CURL* handle, HttpResponse* response) {
+    long newConnections = 0;
+    curl_off_t downloaded = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response->status);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &response->seconds);
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &newConnections);
+    curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+    requestCount++;
+    bytesReceived += static_cast<size_t>(downloaded);
+    if (newConnections == 0) {
+        reusedCount++;
+    }
+}
+
+/** @brief sends a request on a pooled handle and waits for the response
+ * @param request the request to send
+ * @return the response, result is set to the curl error if the transfer failed
+ */
+HttpResponse CurlPool::perform(const HttpRequest& request) {
+    HttpResponse response;
+    CURL* handle = acquire(request.url);
+    if (!handle) {
+        return response;
+    }
+
+    curl_slist* headers = nullptr;
+    configure(handle, request, &response, &headers);
+    response.result = curl_easy_perform(handle);
+    if (response.result == CURLE_OK) {
+        complete(handle, &response);
+    }
+
+    curl_slist_free_all(headers);
+    release(handle);
+    return response;
+}
+
+/** @brief getter method for the number of completed requests
+ * @return requestCount
+ */
+size_t CurlPool::getRequestCount() const {
+    return requestCount;
+}
+
+/** @brief getter method for the number of requests that reused an open connection
+ * @return reusedCount
+ */
+size_t CurlPool::getReusedCount() const {
+    return reusedCount;
+}
+
+/** @brief getter method for the fraction of requests that reused an open connection
+ * @return the reuse ratio between 0 and 1
+ */
+double CurlPool::getReuseRatio() const {
+    size_t total = requestCount;
+    return total == 0 ? 0.0 : static_cast<double>(reusedCount) / total;
+}
+
+/** @brief getter method for the number of response body bytes received
+ * @return bytesReceived
+ */
+size_t CurlPool::getBytesReceived() const {
+    return bytesReceived;
+}
+
+/** @brief getter method for the per host handle limit
+ * @return maxPerHost
+ */
+size_t CurlPool::getMaxPerHost() const {
+    return maxPerHost;
+}
+
+/** @brief builds a one line summary of the pool counters
+ * @return the summary
+ */
+string CurlPool::getStatsReport() const {
+    ostringstream report;
+    report << "Connections: " << requestCount << " requests, " << reusedCount << " reused ("
+           << fixed << setprecision(1) << getReuseRatio() * 100.0 << "%), "
+           << bytesReceived / 1024 << " KiB received";
+    return report.str();
+}
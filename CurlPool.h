@@ -0,0 +1,89 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the pooled curl handle layer shared by every SpotifyAPI request
+*/
+#ifndef CURLPOOL_H
+#define CURLPOOL_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <curl/curl.h>
+
+using namespace std;
+
+//describes one HTTP request to be sent through the pool
+struct HttpRequest {
+    string method = "GET";
+    string url;
+    vector<string> headers;
+    string body;
+};
+
+//holds the outcome of one HTTP request
+struct HttpResponse {
+    CURLcode result = CURLE_FAILED_INIT;
+    long status = 0;
+    string body;
+    string etag; //ETag response header, empty if the server sent none
+    int retryAfterSeconds = -1; //Retry-After response header, sent with 429 Too Many Requests, -1 if absent
+    double seconds = 0; //total time of the transfer
+    bool fromCache = false; //true when the body was served locally after a 304 Not Modified
+
+    bool ok() const { return result == CURLE_OK; }
+};
+
+class CurlPool {
+public:
+    //initialize public functions to be used in CurlPool.cpp
+    explicit CurlPool(size_t maxPerHost = 4);
+    ~CurlPool();
+    CurlPool(const CurlPool&) = delete;
+    CurlPool& operator=(const CurlPool&) = delete;
+
+    HttpResponse perform(const HttpRequest& request);
+    CURL* acquire(const string& url);
+    void release(CURL* handle);
+    void configure(CURL* handle, const HttpRequest& request, HttpResponse* response, curl_slist** headers);
+    void complete(CURL* handle, HttpResponse* response);
+
+    size_t getRequestCount() const;
+    size_t getReusedCount() const;
+    double getReuseRatio() const;
+    size_t getBytesReceived() const;
+    string getStatsReport() const;
+    size_t getMaxPerHost() const;
+
+    static string hostOf(const string& url);
+
+private:
+    //idle handles and the number of handles checked out for a single host
+    struct HostSlot {
+        vector<CURL*> idle;
+        size_t active = 0;
+    };
+
+    size_t maxPerHost; //maximum number of handles (and so connections) per host
+    CURLSH* share; //shared DNS and TLS session cache, safe to use from every thread
+    mutex shareLocks[CURL_LOCK_DATA_LAST]; //one lock per kind of shared data
+
+    mutex poolMutex;
+    condition_variable handleReleased;
+    map<string, HostSlot> hosts;
+    map<CURL*, string> checkedOut;
+
+    atomic<size_t> requestCount;
+    atomic<size_t> reusedCount;
+    atomic<size_t> bytesReceived;
+
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, string* data);
+    static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, HttpResponse* response);
+    static void lockShared(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlockShared(CURL* handle, curl_lock_data data, void* userptr);
+};
+
+#endif // CURLPOOL_H
@@ -0,0 +1,76 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class remembers which playlists and tracks a merge has already seen, so a playlist
+ *        submitted twice is fetched once and a track shared by several playlists is added once
+*/
+
+#include "Deduplicator.h"
+
+/** @brief Constructor for the Deduplicator class
+ */
+Deduplicator::Deduplicator() : skippedPlaylists(0), skippedTracks(0) {}
+
+/** @brief sizes the track set up front so large merges do not rehash while adding
+ * @param expectedTracks number of track IDs about to be added
+ */
+void Deduplicator::reserveTracks(size_t expectedTracks) {
+    tracks.reserve(tracks.size() + expectedTracks);
+}
+
+/** @brief records a playlist
+ * @param playlistID normalized playlist ID, as returned by SpotifyAPI::extractPlaylistID
+ * @return true the first time the playlist is seen, false if it has to be skipped
+ */
+bool Deduplicator::addPlaylist(const string& playlistID) {
+    //an url that is not a playlist is rejected, it is not a duplicate so it is not counted
+    if (playlistID.empty()) {
+        return false;
+    }
+    if (!playlists.insert(playlistID).second) {
+        skippedPlaylists++;
+        return false;
+    }
+    return true;
+}
+
+/** @brief records a track
+ * @param trackID ID of the track
+ * @return true the first time the track is seen, false if it has to be skipped
+ */
+bool Deduplicator::addTrack(const TrackId& trackID) {
+    if (!tracks.insert(trackID).second) {
+        skippedTracks++;
+        return false;
+    }
+    return true;
+}
+
+/** @brief getter method for the number of playlist fetches avoided
+ * @return skippedPlaylists
+ */
+size_t Deduplicator::getSkippedPlaylists() const {
+    return skippedPlaylists;
+}
+
+/** @brief getter method for the number of track insertions avoided
+ * @return skippedTracks
+ */
+size_t Deduplicator::getSkippedTracks() const {
+    return skippedTracks;
+}
+
+/** @brief getter method for the number of distinct tracks seen
+ * @return the size of the track set
+ */
+size_t Deduplicator::getUniqueTracks() const {
+    return tracks.size();
+}
+
+/** @brief builds a one line summary of the work avoided
+ * @return the summary
+ */
+string Deduplicator::getReport() const {
+    return "Deduplication: skipped " + to_string(skippedPlaylists) + " playlist fetches and " +
+           to_string(skippedTracks) + " track adds, " + to_string(tracks.size()) + " unique tracks";
+}
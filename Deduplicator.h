@@ -0,0 +1,34 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the Deduplicator class
+*/
+#ifndef DEDUPLICATOR_H
+#define DEDUPLICATOR_H
+//include necessary libraries
+#include <string>
+#include <unordered_set>
+#include "TrackId.h"
+
+using namespace std;
+
+class Deduplicator {
+public:
+    //initialize public functions to be used in Deduplicator.cpp
+    Deduplicator();
+    void reserveTracks(size_t expectedTracks);
+    bool addPlaylist(const string& playlistID);
+    bool addTrack(const TrackId& trackID);
+    size_t getSkippedPlaylists() const;
+    size_t getSkippedTracks() const;
+    size_t getUniqueTracks() const;
+    string getReport() const;
+
+private:
+    unordered_set<string> playlists; //normalized IDs of the playlists already queued for fetching
+    unordered_set<TrackId> tracks; //IDs of the tracks already queued for insertion
+    size_t skippedPlaylists;
+    size_t skippedTracks;
+};
+
+#endif // DEDUPLICATOR_H
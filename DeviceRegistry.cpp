@@ -0,0 +1,198 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class caches the devices of the user with their capabilities and volume, so commands can
+ *        name the device they target instead of relying on whichever one happens to be active, the list
+ *        is refreshed on a timer and whenever playback moves to a device it does not know
+*/
+
+#include "DeviceRegistry.h"
+#include <iostream>
+#include <sstream>
+#include <future>
+#include <QPointer>
+
+/** @brief Constructor for the DeviceRegistry class, no request is made until refresh or start
+ * @param api used to list the devices, with its current access token
+ * @param refreshIntervalMs time between two background refreshes
+ * @param parent owner of the registry, it must live on the GUI thread
+ */
+DeviceRegistry::DeviceRegistry(SpotifyAPI& api, int refreshIntervalMs, QObject* parent)
+    : QObject(parent), api(api), refreshing(false), refreshes(0), failures(0), joined(0), targetChanges(0) {
+    timer = new QTimer(this);
+    timer->setInterval(refreshIntervalMs);
+    connect(timer, &QTimer::timeout, this, &DeviceRegistry::refreshAsync);
+}
+
+/** @brief lists the devices and waits for the result, used by the startup step
+ * @return false if the devices could not be listed, the cached list is kept then
+ */
+bool DeviceRegistry::refresh() {
+    auto listed = make_shared<promise<bool>>();
+    future<bool> result = listed->get_future();
+    listDevices([listed](bool ok) { listed->set_value(ok); });
+    return result.get();
+}
+
+/** @brief starts the background refreshes, call on the GUI thread
+ */
+void DeviceRegistry::start() {
+    timer->start();
+}
+
+/** @brief lists the devices without waiting, joins the list request in flight if there is one
+ */
+void DeviceRegistry::refreshAsync() {
+    listDevices([](bool) {});
+}
+
+/** @brief sends one list request and stores its result, the signals are emitted on the GUI thread
+ *  Callers that arrive while a request is in flight wait for that one instead of sending another.
+ * @param done called on the request engine thread once the list has been stored or has failed
+ */
+void DeviceRegistry::listDevices(function<void(bool)> done) {
+    {
+        lock_guard<mutex> lock(devicesMutex);
+        waiters.push_back(move(done));
+        if (refreshing) {
+            joined++;
+            return;
+        }
+        refreshing = true;
+    }
+    //the registry outlives the request engine, which calls back with a failure for aborted requests
+    QPointer<DeviceRegistry> self(this);
+    api.getDevicesAsync(api.getAccessToken(), [this, self](bool ok, vector<Device> listed) {
+        bool targetMoved = false;
+        vector<function<void(bool)>> waiting;
+        {
+            lock_guard<mutex> lock(devicesMutex);
+            if (ok) {
+                targetMoved = store(move(listed));
+            }
+            else {
+                failures++;
+            }
+            refreshing = false;
+            waiting.swap(waiters);
+        }
+        if (ok && self) {
+            QMetaObject::invokeMethod(self.data(), [self, targetMoved]() {
+                if (!self) return;
+                emit self->devicesChanged();
+                if (targetMoved) emit self->targetChanged(self->getTargetDeviceID());
+            }, Qt::QueuedConnection);
+        }
+        for (auto& waiter : waiting) {
+            waiter(ok);
+        }
+    });
+}
+
+/** @brief replaces the cached list and picks the target again, devicesMutex must be held
+ * @param listed the devices just listed
+ * @return true if the target changed
+ */
+bool DeviceRegistry::store(vector<Device> listed) {
+    refreshes++;
+    devices = move(listed);
+    string next = chooseTarget(devices, target);
+    if (next == target) {
+        return false;
+    }
+    target = next;
+    targetChanges++;
+    return true;
+}
+
+/** @brief picks the device commands are sent to: the active one, else the previous target while it is
+ *  still listed, else the first device that accepts commands
+ * @param devices the listed devices
+ * @param previous the current target, empty for none
+ * @return the device ID, empty if no device can be targeted
+ */
+string DeviceRegistry::chooseTarget(const vector<Device>& devices, const string& previous) {
+    const Device* chosen = nullptr;
+    for (const Device& device : devices) {
+        if (!device.canTarget()) {
+            continue;
+        }
+        if (device.isActive) {
+            return device.id;
+        }
+        if (!chosen || device.id == previous) {
+            chosen = &device;
+        }
+    }
+    return chosen ? chosen->id : string();
+}
+
+/** @brief getter method for the cached device list
+ * @return a copy of the list
+ */
+vector<Device> DeviceRegistry::getDevices() const {
+    lock_guard<mutex> lock(devicesMutex);
+    return devices;
+}
+
+/** @brief getter method for the device commands are sent to
+ * @return the device ID, empty to let the Web API use the active device
+ */
+string DeviceRegistry::getTargetDeviceID() const {
+    lock_guard<mutex> lock(devicesMutex);
+    return target;
+}
+
+/** @brief finds a device in the cached list
+ * @param deviceID the device
+ * @param device receives the cached state of the device
+ * @return false if the device is not listed
+ */
+bool DeviceRegistry::lookup(const string& deviceID, Device& device) const {
+    lock_guard<mutex> lock(devicesMutex);
+    for (const Device& listed : devices) {
+        if (listed.id == deviceID) {
+            device = listed;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief updates the cache from a playback snapshot, the list is refreshed when playback moves to
+ *  another device, since the user moved it from another app; otherwise the timer keeps it current
+ * @param deviceID device of the snapshot, empty if nothing is playing
+ * @param volumePercent volume reported for the device, negative if unknown
+ */
+void DeviceRegistry::notePlayback(const string& deviceID, int volumePercent) {
+    if (deviceID.empty()) {
+        return;
+    }
+    bool moved = false;
+    {
+        lock_guard<mutex> lock(devicesMutex);
+        //a device missing from the list would otherwise be refreshed on every poll
+        moved = deviceID != playbackDevice;
+        playbackDevice = deviceID;
+        for (Device& device : devices) {
+            if (device.id == deviceID) {
+                if (volumePercent >= 0) device.volumePercent = volumePercent;
+                break;
+            }
+        }
+    }
+    if (moved) {
+        refreshAsync();
+    }
+}
+
+/** @brief builds a one line summary of the registry counters
+ * @return the summary
+ */
+string DeviceRegistry::getStatsReport() const {
+    lock_guard<mutex> lock(devicesMutex);
+    ostringstream report;
+    report << "Devices: " << devices.size() << " listed, " << refreshes << " refreshes, " << failures
+           << " failed, " << joined << " joined one in flight, " << targetChanges << " target changes";
+    return report.str();
+}
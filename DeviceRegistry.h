@@ -0,0 +1,65 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables, methods and signals of the DeviceRegistry class
+*/
+#ifndef DEVICEREGISTRY_H
+#define DEVICEREGISTRY_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <QObject>
+#include <QTimer>
+#include "SpotifyAPI.h"
+
+using namespace std;
+
+//keeps the device list of the user, refreshed in the background, and picks the device commands are sent to
+class DeviceRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    //initialize public functions to be used in DeviceRegistry.cpp
+    DeviceRegistry(SpotifyAPI& api, int refreshIntervalMs = 30000, QObject* parent = nullptr);
+
+    bool refresh();
+    void start();
+    vector<Device> getDevices() const;
+    string getTargetDeviceID() const;
+    bool lookup(const string& deviceID, Device& device) const;
+    void notePlayback(const string& deviceID, int volumePercent);
+    string getStatsReport() const;
+
+public slots:
+    void refreshAsync();
+
+signals:
+    //the device list has been replaced
+    void devicesChanged();
+    //commands now go to another device, empty if no device can be targeted
+    void targetChanged(const string& deviceID);
+
+private:
+    SpotifyAPI& api;
+    QTimer* timer;
+
+    mutable mutex devicesMutex; //the list is stored by the request engine thread and read by the GUI thread
+    vector<Device> devices;
+    string target;
+    string playbackDevice; //device of the last playback snapshot noted
+    bool refreshing; //a list request is in flight
+    vector<function<void(bool)>> waiters; //callers waiting for the request in flight
+
+    size_t refreshes;
+    size_t failures;
+    size_t joined; //refreshes requested while one was in flight
+    size_t targetChanges;
+
+    void listDevices(function<void(bool)> done);
+    bool store(vector<Device> listed);
+    static string chooseTarget(const vector<Device>& devices, const string& previous);
+};
+
+#endif // DEVICEREGISTRY_H
@@ -0,0 +1,60 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class runs a frame rate timer on the GUI thread and records the gaps between its ticks,
+ *        so any work that blocks painting and input shows up as a stall
+*/
+
+#include "FrameMonitor.h"
+
+/** @brief Constructor for the FrameMonitor class, starts measuring right away
+ * @param parent owner of the monitor, it must live on the GUI thread
+ * @param frameMs interval of the timer
+ * @param stallMs gap from which a frame counts as stalled
+ */
+FrameMonitor::FrameMonitor(QObject* parent, int frameMs, int stallMs)
+    : QObject(parent), timer(new QTimer(this)), frameMs(frameMs), stallMs(stallMs), frames(0), stalls(0), maxGapMs(0) {
+    timer->setTimerType(Qt::PreciseTimer);
+    timer->setInterval(frameMs);
+    connect(timer, &QTimer::timeout, this, &FrameMonitor::frame);
+    clock.start();
+    timer->start();
+}
+
+/** @brief records the gap since the previous tick
+ */
+void FrameMonitor::frame() {
+    qint64 gap = clock.restart();
+    //the first tick waits for the event loop to start, which is not a stall
+    if (frames++ == 0) {
+        return;
+    }
+    if (gap > maxGapMs) {
+        maxGapMs = gap;
+    }
+    if (gap >= stallMs) {
+        stalls++;
+    }
+}
+
+/** @brief getter method for the longest gap between two ticks
+ * @return maxGapMs
+ */
+qint64 FrameMonitor::getMaxGapMs() const {
+    return maxGapMs;
+}
+
+/** @brief getter method for the number of gaps of at least stallMs
+ * @return stalls
+ */
+size_t FrameMonitor::getStallCount() const {
+    return stalls;
+}
+
+/** @brief builds a one line summary of the frame counters
+ * @return the summary
+ */
+string FrameMonitor::getReport() const {
+    return "GUI frames: " + to_string(frames) + " frames of " + to_string(frameMs) + " ms, " + to_string(stalls) +
+           " stalls of " + to_string(stallMs) + " ms or more, longest gap " + to_string(maxGapMs) + " ms";
+}
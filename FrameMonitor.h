@@ -0,0 +1,40 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the FrameMonitor class
+*/
+#ifndef FRAMEMONITOR_H
+#define FRAMEMONITOR_H
+//include necessary libraries
+#include <string>
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+using namespace std;
+
+//measures how late the GUI thread gets to a timer due every frame, a late frame means the thread was blocked
+class FrameMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    //initialize public functions to be used in FrameMonitor.cpp
+    explicit FrameMonitor(QObject* parent = nullptr, int frameMs = 16, int stallMs = 50);
+
+    qint64 getMaxGapMs() const;
+    size_t getStallCount() const;
+    string getReport() const;
+
+private:
+    QTimer* timer;
+    QElapsedTimer clock;
+    int frameMs;
+    int stallMs; //a gap at least this long counts as a stall
+    size_t frames;
+    size_t stalls;
+    qint64 maxGapMs;
+
+    void frame();
+};
+
+#endif // FRAMEMONITOR_H
@@ -0,0 +1,123 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class sends the playback commands of the GUI off the GUI thread. Each device has its own
+ *        queue with one request in flight so the commands arrive in the order they were clicked, and
+ *        waiting commands that a newer one makes redundant are dropped before they are sent
+*/
+
+#include "PlaybackCommandQueue.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <QPointer>
+
+/** @brief Constructor for the PlaybackCommandQueue class
+ * @param api used to send the commands with its current access token, its request engine keeps the
+ *        connections open between them
+ * @param parent owner of the queue, it must live on the GUI thread
+ */
+PlaybackCommandQueue::PlaybackCommandQueue(SpotifyAPI& api, QObject* parent)
+    : QObject(parent), api(api), queued(0), collapsed(0) {
+}
+
+/** @brief queues a command for a device, it is sent once the commands before it have completed
+ *  A play command decides both what plays and that it plays, so it replaces every waiting command.
+ *  Resume and pause only decide the latter, so they replace the waiting resumes and pauses after the
+ *  last play command, and are dropped if playback is already left in that state (play, pause, play
+ *  while the first play is in flight sends nothing more).
+ * @param deviceID device to send the command to, empty for the active device
+ * @param command the command
+ */
+void PlaybackCommandQueue::enqueue(const string& deviceID, const PlaybackCommand& command) {
+    queued++;
+    DeviceQueue& queue = devices[deviceID];
+    if (!command.toggles()) {
+        collapsed += queue.waiting.size();
+        queue.waiting.clear();
+    }
+    else {
+        while (!queue.waiting.empty() && queue.waiting.back().command.toggles()) {
+            queue.waiting.pop_back();
+            collapsed++;
+        }
+        const PlaybackCommand* previous = !queue.waiting.empty() ? &queue.waiting.back().command
+                                        : queue.inFlight ? &queue.sending.command : nullptr;
+        if (previous && previous->playing() == command.playing()) {
+            collapsed++;
+            return;
+        }
+    }
+    queue.waiting.push_back({command, Clock::now()});
+    if (!queue.inFlight) {
+        sendNext(deviceID);
+    }
+}
+
+/** @brief sends the next waiting command of a device, its completion is handled on the GUI thread
+ * @param deviceID the device
+ */
+void PlaybackCommandQueue::sendNext(const string& deviceID) {
+    DeviceQueue& queue = devices[deviceID];
+    queue.sending = queue.waiting.front();
+    queue.waiting.pop_front();
+    queue.inFlight = true;
+    queue.sentAt = Clock::now();
+
+    //the guard covers responses that are aborted while the window is being torn down
+    QPointer<PlaybackCommandQueue> self(this);
+    api.sendPlaybackCommandAsync(api.getAccessToken(), deviceID, queue.sending.command, [self, deviceID](HttpResponse response) {
+        bool ok = response.ok() && response.status < 300;
+        if (!ok) {
+            cerr << "Playback command failed: " << (response.ok() ? "HTTP " + to_string(response.status)
+                                                                  : string(curl_easy_strerror(response.result))) << endl;
+        }
+        if (self) {
+            QMetaObject::invokeMethod(self.data(), [self, deviceID, ok]() { if (self) self->completed(deviceID, ok); },
+                                      Qt::QueuedConnection);
+        }
+    });
+}
+
+/** @brief records the latency of a completed command and sends the next one of its device
+ * @param deviceID the device
+ * @param ok false if the command failed
+ */
+void PlaybackCommandQueue::completed(const string& deviceID, bool ok) {
+    DeviceQueue& queue = devices[deviceID];
+    Clock::time_point now = Clock::now();
+    KindStats& kind = stats[queue.sending.command.kind];
+    kind.sent++;
+    if (!ok) {
+        kind.failed++;
+        //a device that went away or became restricted is the usual cause, the target is worth listing again
+        emit commandFailed(deviceID);
+    }
+    kind.latencyMsTotal += chrono::duration<double, milli>(now - queue.sending.queuedAt).count();
+    kind.requestMsTotal += chrono::duration<double, milli>(now - queue.sentAt).count();
+    queue.inFlight = false;
+
+    if (!queue.waiting.empty()) {
+        sendNext(deviceID);
+        return;
+    }
+    emit settled(deviceID);
+}
+
+/** @brief builds a summary of the queue counters with the latency of each kind of command
+ * @return the summary
+ */
+string PlaybackCommandQueue::getStatsReport() const {
+    ostringstream report;
+    report << "Playback commands: " << queued << " queued, " << collapsed << " collapsed" << fixed << setprecision(1);
+    for (int kind = PlaybackCommand::Resume; kind <= PlaybackCommand::PlayContext; kind++) {
+        const KindStats& counters = stats[kind];
+        if (counters.sent == 0) {
+            continue;
+        }
+        report << ", " << PlaybackCommand{static_cast<PlaybackCommand::Kind>(kind), ""}.name() << " " << counters.sent
+               << " sent (" << counters.failed << " failed) " << counters.latencyMsTotal / counters.sent << " ms ("
+               << counters.requestMsTotal / counters.sent << " ms request)";
+    }
+    return report.str();
+}
@@ -0,0 +1,68 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables, methods and signals of the PlaybackCommandQueue class
+*/
+#ifndef PLAYBACKCOMMANDQUEUE_H
+#define PLAYBACKCOMMANDQUEUE_H
+//include necessary libraries
+#include <string>
+#include <deque>
+#include <map>
+#include <chrono>
+#include <QObject>
+#include "SpotifyAPI.h"
+
+using namespace std;
+
+//sends playback commands in click order, one at a time per device, dropping the ones a later command makes redundant
+class PlaybackCommandQueue : public QObject {
+    Q_OBJECT
+
+public:
+    //initialize public functions to be used in PlaybackCommandQueue.cpp
+    explicit PlaybackCommandQueue(SpotifyAPI& api, QObject* parent = nullptr);
+
+    void enqueue(const string& deviceID, const PlaybackCommand& command);
+    string getStatsReport() const;
+
+signals:
+    //the queue of a device has drained, its playback state is worth reading again
+    void settled(const string& deviceID);
+    //a command sent to the device failed
+    void commandFailed(const string& deviceID);
+
+private:
+    using Clock = chrono::steady_clock;
+
+    struct Queued {
+        PlaybackCommand command;
+        Clock::time_point queuedAt;
+    };
+    //commands of one device, the front one is sent only after the previous one has completed
+    struct DeviceQueue {
+        deque<Queued> waiting;
+        bool inFlight = false;
+        Queued sending;
+        Clock::time_point sentAt;
+    };
+    //counters of one kind of command
+    struct KindStats {
+        size_t sent = 0;
+        size_t failed = 0;
+        double latencyMsTotal = 0; //from the click to the response, queueing included
+        double requestMsTotal = 0; //from the request to the response
+    };
+
+    SpotifyAPI& api;
+    map<string, DeviceQueue> devices;
+
+    size_t queued; //commands received from the UI
+    size_t collapsed; //commands dropped because a later one made them redundant
+    KindStats stats[4];
+
+    void sendNext(const string& deviceID);
+    void completed(const string& deviceID, bool ok);
+};
+
+#endif // PLAYBACKCOMMANDQUEUE_H
@@ -0,0 +1,82 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class times the now playing polls from the playback progress: the next poll comes just
+ *        after the current track should end, and polls back off while playback is paused or idle
+*/
+
+#include "PlaybackScheduler.h"
+#include <algorithm>
+
+/** @brief Constructor for the PlaybackScheduler class
+ * @param playingIntervalMs longest wait between polls while a track is playing
+ * @param pausedIntervalMs first wait while paused or idle, it doubles on every poll that finds no change
+ * @param idleIntervalMs longest wait while paused or idle
+ * @param hiddenIntervalMs shortest wait while the window is hidden
+ */
+PlaybackScheduler::PlaybackScheduler(int playingIntervalMs, int pausedIntervalMs, int idleIntervalMs, int hiddenIntervalMs)
+    : playingIntervalMs(playingIntervalMs), pausedIntervalMs(pausedIntervalMs), idleIntervalMs(idleIntervalMs),
+      hiddenIntervalMs(hiddenIntervalMs), unchangedPolls(0), endExpected(false), detectionMsTotal(0), detectionCount(0) {
+}
+
+/** @brief records the result of a poll and works out when to poll next
+ * @param state the playback state that was just read
+ * @param visible false while the window is minimized or hidden
+ * @return milliseconds until the next poll
+ */
+int PlaybackScheduler::update(const CurrentlyPlaying& state, bool visible) {
+    Clock::time_point now = Clock::now();
+    string newTrackId = state.hasTrack ? state.track.id : string();
+    //a change seen after the track was due to end measures how quickly changes are detected
+    if (newTrackId != trackId && endExpected && now >= expectedEnd && !newTrackId.empty()) {
+        detectionMsTotal += chrono::duration<double, milli>(now - expectedEnd).count();
+        detectionCount++;
+    }
+    trackId = newTrackId;
+
+    int delay;
+    if (state.hasTrack && state.isPlaying) {
+        unchangedPolls = 0;
+        int remainingMs = max(0, state.track.durationMs - state.progressMs);
+        expectedEnd = now + chrono::milliseconds(remainingMs);
+        endExpected = true;
+        delay = min(remainingMs + trackChangeSlackMs, playingIntervalMs);
+    }
+    else {
+        endExpected = false;
+        //doubling from the paused interval: 5 s, 10 s, 20 s, ... up to the idle interval
+        int shift = min(unchangedPolls, 16);
+        delay = static_cast<int>(min<long long>(static_cast<long long>(pausedIntervalMs) << shift, idleIntervalMs));
+        unchangedPolls++;
+    }
+    if (!visible) {
+        delay = max(delay, hiddenIntervalMs);
+    }
+    return max(delay, minIntervalMs);
+}
+
+/** @brief called after a playback command, so the paused back off starts over
+ */
+void PlaybackScheduler::expectChange() {
+    unchangedPolls = 0;
+}
+
+/** @brief estimates the progress of a track without polling
+ * @param state the playback state read by a poll
+ * @param polledAt when that poll was made
+ * @return the progress read by the poll plus the time since, while playing, never past the end of the track
+ */
+int PlaybackScheduler::estimateProgressMs(const CurrentlyPlaying& state, chrono::steady_clock::time_point polledAt) {
+    if (!state.hasTrack || !state.isPlaying) {
+        return state.progressMs;
+    }
+    long long elapsed = chrono::duration_cast<chrono::milliseconds>(Clock::now() - polledAt).count();
+    return static_cast<int>(min<long long>(state.progressMs + elapsed, state.track.durationMs));
+}
+
+/** @brief getter method for how long after the end of a track the next one was seen, on average
+ * @return the average in milliseconds, 0 if no track has ended yet
+ */
+double PlaybackScheduler::getAverageDetectionMs() const {
+    return detectionCount == 0 ? 0.0 : detectionMsTotal / detectionCount;
+}
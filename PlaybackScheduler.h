@@ -0,0 +1,47 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the PlaybackScheduler class
+*/
+#ifndef PLAYBACKSCHEDULER_H
+#define PLAYBACKSCHEDULER_H
+//include necessary libraries
+#include <string>
+#include <chrono>
+#include "SpotifyTypes.h"
+
+using namespace std;
+
+//decides when the playback state is polled next and estimates the progress in between
+class PlaybackScheduler {
+public:
+    //initialize public functions to be used in PlaybackScheduler.cpp
+    PlaybackScheduler(int playingIntervalMs = 10000, int pausedIntervalMs = 5000, int idleIntervalMs = 60000,
+                      int hiddenIntervalMs = 30000);
+
+    int update(const CurrentlyPlaying& state, bool visible);
+    void expectChange();
+    double getAverageDetectionMs() const;
+    static int estimateProgressMs(const CurrentlyPlaying& state, chrono::steady_clock::time_point polledAt);
+
+    static constexpr int trackChangeSlackMs = 300; //poll this long after the expected end of the track
+    static constexpr int minIntervalMs = 500;
+
+private:
+    using Clock = chrono::steady_clock;
+
+    int playingIntervalMs; //longest wait while playing, bounds how late a skip on another device is seen
+    int pausedIntervalMs; //first wait while paused or idle, doubled on every unchanged poll
+    int idleIntervalMs; //longest wait while paused or idle
+    int hiddenIntervalMs; //shortest wait while the window is hidden
+
+    string trackId;
+    int unchangedPolls; //polls in a row that found playback paused or idle
+    Clock::time_point expectedEnd; //when the current track should end, if it is playing
+    bool endExpected;
+
+    double detectionMsTotal; //time between the expected end of a track and the poll that saw the next one
+    size_t detectionCount;
+};
+
+#endif // PLAYBACKSCHEDULER_H
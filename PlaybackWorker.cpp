@@ -0,0 +1,77 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class polls and parses the playback state away from the GUI thread and publishes each
+ *        result as an immutable snapshot, the blocking request never runs where painting happens
+*/
+
+#include "PlaybackWorker.h"
+#include <QThread>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+/** @brief Constructor for the PlaybackWorker class, the worker is moved to its thread before start is called
+ * @param api used to read the playback state and the current access token, both are thread safe
+ */
+PlaybackWorker::PlaybackWorker(SpotifyAPI& api)
+    : api(api), timer(nullptr), visible(true), polls(0), guiThreadPolls(0), pollNs(0) {
+    qRegisterMetaType<PlaybackSnapshotPtr>("PlaybackSnapshotPtr");
+}
+
+/** @brief starts polling, runs on the worker thread once it has started
+ */
+void PlaybackWorker::start() {
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, &PlaybackWorker::poll);
+    timer->start(0);
+}
+
+/** @brief reads the playback state, publishes it and times the next poll
+ */
+void PlaybackWorker::poll() {
+    QElapsedTimer pollTimer;
+    pollTimer.start();
+    if (QThread::currentThread() == QCoreApplication::instance()->thread()) {
+        guiThreadPolls++;
+    }
+
+    auto snapshot = make_shared<PlaybackSnapshot>();
+    //taken before the request is sent, a state read before a volume change must not look newer than it
+    snapshot->polledAt = chrono::steady_clock::now();
+    snapshot->state = api.getCurrentlyPlaying(api.getAccessToken());
+    if (snapshot->state.hasTrack && snapshot->state.track.id != lastTrackId) {
+        lastTrackId = snapshot->state.track.id;
+        snapshot->trackChanged = true;
+    }
+    snapshot->nextPollMs = scheduler.update(snapshot->state, visible);
+
+    polls++;
+    pollNs += pollTimer.nsecsElapsed();
+    snapshot->polls = polls;
+    snapshot->guiThreadPolls = guiThreadPolls;
+    snapshot->pollNs = pollNs;
+    snapshot->averageDetectionMs = scheduler.getAverageDetectionMs();
+
+    timer->start(snapshot->nextPollMs);
+    emit snapshotReady(snapshot);
+}
+
+/** @brief polls shortly, used after a playback command since the state is likely to have changed
+ */
+void PlaybackWorker::pollSoon() {
+    scheduler.expectChange();
+    if (timer) {
+        timer->start(PlaybackScheduler::minIntervalMs);
+    }
+}
+
+/** @brief tells the worker whether the window is visible, polls are sparse while it is not
+ * @param visible false while the window is minimized
+ */
+void PlaybackWorker::setVisible(bool visible) {
+    this->visible = visible;
+    if (visible && timer) {
+        timer->start(0);
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the PlaybackSnapshot record and the variables, methods and signals of
+ *        the PlaybackWorker class
+*/
+#ifndef PLAYBACKWORKER_H
+#define PLAYBACKWORKER_H
+//include necessary libraries
+#include <string>
+#include <memory>
+#include <chrono>
+#include <QObject>
+#include <QTimer>
+#include <QMetaType>
+#include "SpotifyAPI.h"
+#include "PlaybackScheduler.h"
+
+using namespace std;
+
+//playback state read by one poll, never changed once published
+struct PlaybackSnapshot {
+    CurrentlyPlaying state;
+    chrono::steady_clock::time_point polledAt;
+    bool trackChanged = false; //the track differs from the one of the previous snapshot that had a track
+    int nextPollMs = 0;
+
+    //counters of the worker when the snapshot was taken
+    size_t polls = 0;
+    size_t guiThreadPolls = 0; //polls that ran on the GUI thread, always 0 unless the worker is misused
+    qint64 pollNs = 0; //time spent polling and parsing, on the worker thread
+    double averageDetectionMs = 0;
+
+    //progress of the track estimated from the poll and the time since
+    int progressMs() const {
+        return PlaybackScheduler::estimateProgressMs(state, polledAt);
+    }
+};
+using PlaybackSnapshotPtr = shared_ptr<const PlaybackSnapshot>;
+Q_DECLARE_METATYPE(PlaybackSnapshotPtr)
+
+//polls the playback state on its own thread, see MainWindow for how it is started
+class PlaybackWorker : public QObject {
+    Q_OBJECT
+
+public:
+    //initialize public functions to be used in PlaybackWorker.cpp
+    explicit PlaybackWorker(SpotifyAPI& api);
+
+public slots:
+    void start();
+    void pollSoon();
+    void setVisible(bool visible);
+
+signals:
+    //delivered to the GUI thread through a queued connection
+    void snapshotReady(PlaybackSnapshotPtr snapshot);
+
+private:
+    SpotifyAPI& api;
+    QTimer* timer; //created in start so that it lives on the worker thread
+    PlaybackScheduler scheduler;
+    bool visible;
+    string lastTrackId;
+
+    size_t polls;
+    size_t guiThreadPolls;
+    qint64 pollNs;
+
+    void poll();
+};
+
+#endif // PLAYBACKWORKER_H
@@ -0,0 +1,153 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class accumulates track uris and adds them to a playlist 100 at a time,
+ *        which is the most the Web API accepts in one request
+*/
+
+#include "PlaylistWriter.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <utility>
+
+/** @brief Constructor for the PlaylistWriter class
+ * @param spotifyApi used to send the writes
+ * @param accessToken string containg access token
+ * @param playlistID string containing the id of the playlist being written
+ * @param startPosition position in the playlist where the first track is inserted
+ */
+PlaylistWriter::PlaylistWriter(SpotifyAPI& spotifyApi, const string& accessToken, const string& playlistID, int startPosition)
+    : spotifyApi(spotifyApi), accessToken(accessToken), playlistID(playlistID), position(startPosition), writing(false), failed(false),
+      writeCount(0), trackCount(0), writeTime(chrono::steady_clock::duration::zero()) {
+    buffer.reserve(SpotifyAPI::maxUrisPerWrite);
+}
+
+/** @brief queues a uri, a write is sent once a full chunk has accumulated, nothing waits for it
+ * @param uri spotify uri of the track, for example spotify:track:(id)
+ */
+void PlaylistWriter::add(const string& uri) {
+    {
+        lock_guard<mutex> lock(writerMutex);
+        buffer.push_back(uri);
+        if (buffer.size() < SpotifyAPI::maxUrisPerWrite) {
+            return;
+        }
+        chunks.push_back(move(buffer));
+        buffer.clear();
+        buffer.reserve(SpotifyAPI::maxUrisPerWrite);
+    }
+    writeNext();
+}
+
+/** @brief queues every uri not sent yet, must be called once the last uri has been added
+ * @param done optional, called on the request engine thread once every chunk has been written, or right away
+ *        if nothing is left to write, with false if a chunk failed and the ones after it were not sent
+ */
+void PlaylistWriter::flush(function<void(bool)> done) {
+    {
+        lock_guard<mutex> lock(writerMutex);
+        if (!buffer.empty()) {
+            chunks.push_back(move(buffer));
+            buffer.clear();
+        }
+        flushed = move(done);
+    }
+    writeNext();
+}
+
+/** @brief sends the next queued chunk unless a write is in flight, the callback of each write sends the one
+ *  after it, so the playlist keeps the order the uris were added in without any thread waiting
+ *  Once a chunk has failed nothing more is sent, the chunks after it would otherwise leave a gap.
+ */
+void PlaylistWriter::writeNext() {
+    vector<string> chunk;
+    int chunkPosition = 0;
+    function<void(bool)> done;
+    bool ok = true;
+    {
+        lock_guard<mutex> lock(writerMutex);
+        if (writing) {
+            return;
+        }
+        if (failed) {
+            chunks.clear();
+            buffer.clear();
+        }
+        if (chunks.empty()) {
+            done = move(flushed);
+            flushed = nullptr;
+            ok = !failed;
+        }
+        else {
+            chunk = move(chunks.front());
+            chunks.pop_front();
+            chunkPosition = position;
+            writing = true;
+        }
+    }
+    if (chunk.empty()) {
+        if (done) done(ok);
+        return;
+    }
+
+    auto self = shared_from_this();
+    auto start = chrono::steady_clock::now();
+    size_t count = chunk.size();
+    spotifyApi.addTracksToPlaylistAsync(accessToken, playlistID, chunk, chunkPosition,
+                                        [self, start, count](string snapshot) {
+        {
+            lock_guard<mutex> lock(self->writerMutex);
+            self->writeTime += chrono::steady_clock::now() - start;
+            self->writeCount++;
+            if (!snapshot.empty()) {
+                self->snapshotID = snapshot;
+                self->position += static_cast<int>(count);
+                self->trackCount += count;
+            }
+            else {
+                self->failed = true;
+            }
+            self->writing = false;
+        }
+        self->writeNext();
+    });
+}
+
+/** @brief getter method for the snapshot id returned by the last successful write
+ * @return snapshotID
+ */
+string PlaylistWriter::getSnapshotID() const {
+    lock_guard<mutex> lock(writerMutex);
+    return snapshotID;
+}
+
+/** @brief getter method for the number of writes sent
+ * @return writeCount
+ */
+size_t PlaylistWriter::getWriteCount() const {
+    lock_guard<mutex> lock(writerMutex);
+    return writeCount;
+}
+
+/** @brief getter method for the number of tracks added
+ * @return trackCount
+ */
+size_t PlaylistWriter::getTrackCount() const {
+    lock_guard<mutex> lock(writerMutex);
+    return trackCount;
+}
+
+/** @brief builds a one line summary of the writes sent so far
+ * @return the summary
+ */
+string PlaylistWriter::getThroughputReport() const {
+    lock_guard<mutex> lock(writerMutex);
+    double seconds = chrono::duration<double>(writeTime).count();
+    ostringstream report;
+    report << "Added " << trackCount << " tracks in " << writeCount << " writes";
+    if (seconds > 0) {
+        report << " (" << fixed << setprecision(1) << trackCount / seconds << " tracks/s)";
+    }
+    return report.str();
+}
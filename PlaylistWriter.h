@@ -0,0 +1,51 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the PlaylistWriter class
+*/
+#ifndef PLAYLISTWRITER_H
+#define PLAYLISTWRITER_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include "SpotifyAPI.h"
+
+using namespace std;
+
+//must be owned by a shared_ptr, a write in flight keeps the writer alive until its callback has run
+class PlaylistWriter : public enable_shared_from_this<PlaylistWriter> {
+public:
+    //initialize public functions to be used in PlaylistWriter.cpp
+    PlaylistWriter(SpotifyAPI& spotifyApi, const string& accessToken, const string& playlistID, int startPosition = 0);
+    void add(const string& uri);
+    void flush(function<void(bool)> done = nullptr);
+    string getSnapshotID() const;
+    size_t getWriteCount() const;
+    size_t getTrackCount() const;
+    string getThroughputReport() const;
+
+private:
+    SpotifyAPI& spotifyApi;
+    string accessToken;
+    string playlistID;
+    mutable mutex writerMutex; //add and flush run on the GUI thread, the write callbacks on the request engine thread
+    int position; //where the next chunk is inserted, keeps the chunks in order
+    vector<string> buffer; //uris waiting to fill a chunk
+    deque<vector<string>> chunks; //full chunks waiting for the write in flight
+    bool writing; //a write is in flight
+    bool failed; //a chunk could not be written, the chunks after it are dropped so the playlist has no gap
+    function<void(bool)> flushed; //called once every chunk queued by flush has been written, or one failed
+    string snapshotID; //snapshot of the playlist after the last successful write
+    size_t writeCount;
+    size_t trackCount;
+    chrono::steady_clock::duration writeTime; //time spent waiting on writes
+
+    void writeNext();
+};
+
+#endif // PLAYLISTWRITER_H
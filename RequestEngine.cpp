@@ -0,0 +1,184 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class runs a curl multi event loop on its own thread so many requests can be in
+ *        flight at once, results are delivered through futures or callbacks
+*/
+
+#include "RequestEngine.h"
+#include <algorithm>
+
+/** @brief Constructor for the RequestEngine class, starts the worker thread
+ * @param pool is the connection pool whose share handle and counters are used
+ */
+RequestEngine::RequestEngine(CurlPool& pool) : pool(pool), stopping(false) {
+    multi = curl_multi_init();
+    //spotify speaks HTTP/2, so concurrent requests are multiplexed over the pooled connections
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(pool.getMaxPerHost()));
+    worker = thread(&RequestEngine::run, this);
+}
+
+/** @brief Destructor, stops the worker thread if stop has not been called already
+ */
+RequestEngine::~RequestEngine() {
+    stop();
+    for (CURL* handle : idle) {
+        curl_easy_cleanup(handle);
+    }
+    curl_multi_cleanup(multi);
+}
+
+/** @brief stops the worker thread and fails every request that has not completed
+ *  The owner calls this before destroying anything the callbacks use. A request submitted from then on,
+ *  including from one of these callbacks, fails right away instead of being queued.
+ */
+void RequestEngine::stop() {
+    deque<unique_ptr<Transfer>> aborted;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+        aborted.swap(pending);
+    }
+    curl_multi_wakeup(multi);
+    worker.join();
+
+    //the worker is gone, so nothing else touches running
+    for (auto& entry : running) {
+        curl_multi_remove_handle(multi, entry.first);
+        curl_easy_cleanup(entry.first);
+        curl_slist_free_all(entry.second->headers);
+        aborted.push_back(move(entry.second));
+    }
+    running.clear();
+    for (auto& transfer : aborted) {
+        transfer->response.result = CURLE_ABORTED_BY_CALLBACK;
+        transfer->callback(move(transfer->response));
+    }
+}
+
+/** @brief queues a request and returns a future for its response
+ * @param request the request to send
+ * @return future that becomes ready once the response has arrived
+ */
+future<HttpResponse> RequestEngine::submit(const HttpRequest& request) {
+    auto promised = make_shared<promise<HttpResponse>>();
+    future<HttpResponse> result = promised->get_future();
+    submit(request, [promised](HttpResponse response) { promised->set_value(move(response)); });
+    return result;
+}
+
+/** @brief queues a request and calls back once its response has arrived
+ * @param request the request to send
+ * @param callback called on the engine thread with the response, it must not block
+ * @param delay how long to wait before sending, used to retry after a 429
+ */
+void RequestEngine::submit(const HttpRequest& request, function<void(HttpResponse)> callback, chrono::milliseconds delay) {
+    auto transfer = make_unique<Transfer>();
+    transfer->request = request;
+    transfer->callback = move(callback);
+    transfer->notBefore = chrono::steady_clock::now() + delay;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (!stopping) {
+            pending.push_back(move(transfer));
+        }
+    }
+    if (transfer) {
+        transfer->response.result = CURLE_ABORTED_BY_CALLBACK;
+        transfer->callback(move(transfer->response));
+        return;
+    }
+    curl_multi_wakeup(multi);
+}
+
+/** @brief adds every queued request that is due to the multi handle, runs on the worker thread
+ * @return milliseconds until the next delayed request is due, -1 if none is waiting
+ */
+int RequestEngine::startPending() {
+    deque<unique_ptr<Transfer>> batch;
+    int nextDueMs = -1;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        auto now = chrono::steady_clock::now();
+        for (auto it = pending.begin(); it != pending.end();) {
+            if ((*it)->notBefore <= now) {
+                batch.push_back(move(*it));
+                it = pending.erase(it);
+                continue;
+            }
+            auto waitMs = chrono::duration_cast<chrono::milliseconds>((*it)->notBefore - now).count() + 1;
+            nextDueMs = nextDueMs < 0 ? static_cast<int>(waitMs) : min(nextDueMs, static_cast<int>(waitMs));
+            ++it;
+        }
+    }
+
+    for (auto& transfer : batch) {
+        CURL* handle;
+        if (!idle.empty()) {
+            handle = idle.back();
+            idle.pop_back();
+        }
+        else {
+            handle = curl_easy_init();
+        }
+        pool.configure(handle, transfer->request, &transfer->response, &transfer->headers);
+        //wait for an existing connection to multiplex on rather than opening a new one
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+        transfer->handle = handle;
+        curl_multi_add_handle(multi, handle);
+        running[handle] = move(transfer);
+    }
+    return nextDueMs;
+}
+
+/** @brief completes a transfer and hands its response to the caller, runs on the worker thread
+ * @param handle the handle whose transfer is done
+ * @param result the curl result of the transfer
+ */
+void RequestEngine::finish(CURL* handle, CURLcode result) {
+    auto it = running.find(handle);
+    if (it == running.end()) {
+        return;
+    }
+    unique_ptr<Transfer> transfer = move(it->second);
+    running.erase(it);
+
+    curl_multi_remove_handle(multi, handle);
+    transfer->response.result = result;
+    if (result == CURLE_OK) {
+        pool.complete(handle, &transfer->response);
+    }
+    curl_slist_free_all(transfer->headers);
+
+    //reset keeps the connection cache so the handle can be reused for the next request
+    curl_easy_reset(handle);
+    idle.push_back(handle);
+
+    transfer->callback(move(transfer->response));
+}
+
+/** @brief event loop of the worker thread
+ */
+void RequestEngine::run() {
+    while (!stopping) {
+        int nextDueMs = startPending();
+
+        int stillRunning = 0;
+        curl_multi_perform(multi, &stillRunning);
+
+        CURLMsg* message;
+        int messagesLeft = 0;
+        while ((message = curl_multi_info_read(multi, &messagesLeft))) {
+            if (message->msg == CURLMSG_DONE) {
+                finish(message->easy_handle, message->data.result);
+            }
+        }
+
+        //sleeps until there is socket activity, a timeout, a delayed request is due, or curl_multi_wakeup from submit
+        curl_multi_poll(multi, nullptr, 0, nextDueMs < 0 ? 1000 : min(nextDueMs, 1000), nullptr);
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the asynchronous request engine that runs SpotifyAPI requests concurrently
+*/
+#ifndef REQUESTENGINE_H
+#define REQUESTENGINE_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <chrono>
+#include <curl/curl.h>
+#include "CurlPool.h"
+
+using namespace std;
+
+class RequestEngine {
+public:
+    //initialize public functions to be used in RequestEngine.cpp
+    explicit RequestEngine(CurlPool& pool);
+    ~RequestEngine();
+    RequestEngine(const RequestEngine&) = delete;
+    RequestEngine& operator=(const RequestEngine&) = delete;
+
+    future<HttpResponse> submit(const HttpRequest& request);
+    void submit(const HttpRequest& request, function<void(HttpResponse)> callback,
+                chrono::milliseconds delay = chrono::milliseconds::zero());
+    void stop();
+
+private:
+    //one request travelling through the multi handle
+    struct Transfer {
+        HttpRequest request;
+        HttpResponse response;
+        function<void(HttpResponse)> callback;
+        curl_slist* headers = nullptr;
+        CURL* handle = nullptr;
+        chrono::steady_clock::time_point notBefore; //the request is not sent before this time
+    };
+
+    CurlPool& pool; //provides the shared caches, handle options and counters
+    CURLM* multi; //drives every transfer from the worker thread
+    thread worker;
+    atomic<bool> stopping;
+
+    mutex queueMutex; //also guards the check of stopping in submit, so nothing is queued once stop has run
+    deque<unique_ptr<Transfer>> pending; //submitted but not yet added to the multi handle
+    map<CURL*, unique_ptr<Transfer>> running; //only touched by the worker thread
+    vector<CURL*> idle; //finished handles kept for their connections, only touched by the worker thread
+
+    void run();
+    int startPending();
+    void finish(CURL* handle, CURLcode result);
+};
+
+#endif // REQUESTENGINE_H
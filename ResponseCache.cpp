@@ -0,0 +1,219 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class keeps the ETag and body of earlier responses on disk, so a request answered
+ *        with 304 Not Modified is served locally, and counts the bandwidth and time this saves
+*/
+
+#include "ResponseCache.h"
+#include "json.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <functional>
+
+/** @brief Constructor for the ResponseCache class, creates the directory if needed and lists the files
+ *  left by earlier sessions
+ * @param directory folder that holds one file per stored response
+ * @param maxBytes total size of the files above which the least recently used ones are removed
+ */
+ResponseCache::ResponseCache(const QString& directory, qint64 maxBytes)
+    : directory(directory), maxBytes(maxBytes), totalBytes(0), clock(0),
+      sent(0), notModified(0), skipped(0), bytesSaved(0), secondsSaved(0), evictions(0) {
+    QDir().mkpath(directory);
+    load();
+}
+
+/** @brief lists the stored files, their recency comes from their modification time since no index is kept
+ */
+void ResponseCache::load() {
+    QFileInfoList stored = QDir(directory).entryInfoList({"*.json"}, QDir::Files, QDir::Time | QDir::Reversed);
+    for (const QFileInfo& info : stored) {
+        StoredFile& file = files[info.filePath()];
+        file.size = info.size();
+        file.lastUsed = ++clock;
+        totalBytes += file.size;
+    }
+    evict();
+}
+
+/** @brief records an access to a file, cacheMutex must be held
+ * @param path the file
+ * @param key key of the entry in the file
+ * @param size size of the file
+ */
+void ResponseCache::touch(const QString& path, const string& key, qint64 size) {
+    StoredFile& file = files[path];
+    //a different key can hash to the same file name, its entry is gone once the file is replaced
+    if (!file.key.empty() && file.key != key) {
+        entries.erase(file.key);
+    }
+    totalBytes += size - file.size;
+    file.size = size;
+    file.key = key;
+    file.lastUsed = ++clock;
+}
+
+/** @brief removes the least recently used files and their entries until the total size is within the limit,
+ *         the file used last is always kept, cacheMutex must be held
+ */
+void ResponseCache::evict() {
+    while (totalBytes > maxBytes && files.size() > 1) {
+        auto oldest = files.begin();
+        for (auto it = files.begin(); it != files.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) {
+                oldest = it;
+            }
+        }
+        if (!oldest->second.key.empty()) {
+            entries.erase(oldest->second.key);
+        }
+        QFile::remove(oldest->first);
+        totalBytes -= oldest->second.size;
+        files.erase(oldest);
+        evictions++;
+    }
+}
+
+/** @brief builds the file name of a key, the key itself is kept inside the file
+ * @param key the url or other key of the entry
+ * @return path of the file
+ */
+QString ResponseCache::pathFor(const string& key) const {
+    ostringstream name;
+    name << hex << setw(16) << setfill('0') << hash<string>()(key) << ".json";
+    return directory + "/" + QString::fromStdString(name.str());
+}
+
+/** @brief looks up a stored response, reading it from disk the first time
+ * @param key the url or other key of the entry
+ * @param entry receives the stored response
+ * @return true if a response is stored for the key
+ */
+bool ResponseCache::lookup(const string& key, Entry& entry) {
+    lock_guard<mutex> lock(cacheMutex);
+    QString path = pathFor(key);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        files[path].lastUsed = ++clock;
+        entry = it->second;
+        return true;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray data = file.readAll();
+    auto stored = nlohmann::json::parse(data.constData(), data.constData() + data.size(), nullptr, false);
+    //a different key can hash to the same file name, so the key is checked too
+    if (stored.is_discarded() || !stored.is_object() || stored.value("key", "") != key) {
+        return false;
+    }
+    Entry& loaded = entries[key];
+    loaded.tag = stored.value("tag", "");
+    loaded.body = stored.value("body", "");
+    loaded.bytes = stored.value("bytes", static_cast<size_t>(0));
+    loaded.seconds = stored.value("seconds", 0.0);
+    entry = loaded;
+    touch(path, key, data.size());
+    return true;
+}
+
+/** @brief stores a response in memory and on disk, replacing any earlier one for the key
+ * @param key the url or other key of the entry
+ * @param entry the response to store
+ */
+void ResponseCache::store(const string& key, const Entry& entry) {
+    nlohmann::json stored = {{"key", key}, {"tag", entry.tag}, {"body", entry.body},
+                             {"bytes", entry.bytes}, {"seconds", entry.seconds}};
+    string data = stored.dump();
+
+    lock_guard<mutex> lock(cacheMutex);
+    QString path = pathFor(key);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        cerr << "Could not write response cache: " << file.fileName().toStdString() << endl;
+        return;
+    }
+    file.write(data.data(), static_cast<qint64>(data.length()));
+    file.close();
+    touch(path, key, static_cast<qint64>(data.length()));
+    entries[key] = entry;
+    evict();
+}
+
+/** @brief counts a request sent with If-None-Match
+ */
+void ResponseCache::recordSent() {
+    lock_guard<mutex> lock(cacheMutex);
+    sent++;
+}
+
+/** @brief counts a 304 response and what it saved compared to downloading the entry again
+ * @param entry the stored response that was served
+ * @param seconds time the 304 response took
+ */
+void ResponseCache::recordNotModified(const Entry& entry, double seconds) {
+    lock_guard<mutex> lock(cacheMutex);
+    notModified++;
+    bytesSaved += entry.bytes;
+    secondsSaved += max(0.0, entry.seconds - seconds);
+}
+
+/** @brief counts a playlist that was not read again because its snapshot_id had not changed
+ * @param entry the stored track IDs of the playlist
+ */
+void ResponseCache::recordSkipped(const Entry& entry) {
+    lock_guard<mutex> lock(cacheMutex);
+    skipped++;
+    bytesSaved += entry.bytes;
+    secondsSaved += entry.seconds;
+}
+
+/** @brief getter method for the number of 304 responses
+ * @return notModified
+ */
+size_t ResponseCache::getNotModifiedCount() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return notModified;
+}
+
+/** @brief getter method for the number of playlists skipped by their snapshot_id
+ * @return skipped
+ */
+size_t ResponseCache::getSkippedCount() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return skipped;
+}
+
+/** @brief getter method for the bytes that did not have to be downloaded
+ * @return bytesSaved
+ */
+size_t ResponseCache::getBytesSaved() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return bytesSaved;
+}
+
+/** @brief getter method for the number of files removed to stay within the size limit
+ * @return evictions
+ */
+size_t ResponseCache::getEvictions() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return evictions;
+}
+
+/** @brief builds a one line summary of the cache counters
+ * @return the summary
+ */
+string ResponseCache::getStatsReport() const {
+    lock_guard<mutex> lock(cacheMutex);
+    ostringstream report;
+    report << "Response cache: " << notModified << " of " << sent << " conditional requests not modified, "
+           << skipped << " unchanged playlists skipped, " << bytesSaved / 1024 << " KiB and "
+           << fixed << setprecision(0) << secondsSaved * 1000.0 << " ms saved, " << evictions << " evictions";
+    return report.str();
+}
@@ -0,0 +1,73 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the ResponseCache class
+*/
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+//include necessary libraries
+#include <string>
+#include <map>
+#include <mutex>
+#include <QString>
+
+using namespace std;
+
+class ResponseCache {
+public:
+    //one stored response, keyed by its url
+    struct Entry {
+        string tag; //ETag of the response, or the snapshot_id of a playlist
+        string body;
+        size_t bytes = 0; //bytes downloaded to build the entry
+        double seconds = 0; //time the full download took
+    };
+
+    //initialize public functions to be used in ResponseCache.cpp
+    explicit ResponseCache(const QString& directory, qint64 maxBytes = 16 * 1024 * 1024);
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    bool lookup(const string& key, Entry& entry);
+    void store(const string& key, const Entry& entry);
+
+    void recordSent();
+    void recordNotModified(const Entry& entry, double seconds);
+    void recordSkipped(const Entry& entry);
+
+    size_t getNotModifiedCount() const;
+    size_t getSkippedCount() const;
+    size_t getBytesSaved() const;
+    size_t getEvictions() const;
+    string getStatsReport() const;
+
+private:
+    //one file of the directory, including the files left by earlier sessions
+    struct StoredFile {
+        qint64 size = 0;
+        uint64_t lastUsed = 0; //value of the clock at the last access, for LRU eviction
+        string key; //key of the entry in the file, empty until it is read or written this session
+    };
+
+    QString directory;
+    qint64 maxBytes;
+    qint64 totalBytes;
+    uint64_t clock; //increases on every access, gives the recency of each file
+    map<string, Entry> entries; //entries already read from or written to disk this session
+    map<QString, StoredFile> files; //path to the file holding an entry, rebuilt from the directory on start
+    mutable mutex cacheMutex;
+
+    size_t sent; //conditional requests sent
+    size_t notModified; //of which answered with 304
+    size_t skipped; //playlists whose snapshot_id had not changed
+    size_t bytesSaved;
+    double secondsSaved;
+    size_t evictions;
+
+    QString pathFor(const string& key) const;
+    void load();
+    void touch(const QString& path, const string& key, qint64 size);
+    void evict();
+};
+
+#endif // RESPONSECACHE_H
@@ -5,8 +5,12 @@
 */
 
 #include "SpotifyAPI.h"
+#include "TrackIdExtractor.h"
 #include <iostream>
 #include <stdexcept>
+#include <cctype>
+#include <unordered_map>
+#include <chrono>
 using json = nlohmann::json;
 // base64 code to be entered (from doing echo ...:... | base64)
 string base64Cred = "";
@@ -14,76 +18,104 @@ string base64Cred = "";
 /** @brief Constructor for the SpotifyAPI class
  * @param clientId is the client id obtained from the developer dashboard
  * @param clientSecret is the client secret obtained from the developer dashboard
+ * @param accountsUrl base url of the accounts service, empty for SPOTIFY_ACCOUNTS_URL or the real service
  */
-SpotifyAPI::SpotifyAPI(const string& clientId, const string& clientSecret)
-    : clientId(clientId), clientSecret(clientSecret) {
-    this->accessToken = getSpotifyAccessToken(base64Cred); //get the access token upon initialization
+SpotifyAPI::SpotifyAPI(const string& clientId, const string& clientSecret, const string& accountsUrl)
+    : clientId(clientId), clientSecret(clientSecret), accountsUrl(resolveAccountsUrl(accountsUrl)), requestEngine(curlPool),
+      trackCache("externals/cache/tracks.cache"), responseCache("externals/cache/responses"),
+      tokens(curlPool, "externals/cache/token.json", base64Cred, this->accountsUrl) {
+    //nothing is requested here, the client credentials token is only fetched if a request is made
+    //before the user has authorized, see getAccessToken
 }
-/** @brief Calculates the total size of the data passed in
- * @param contents is a pointer to the data that has been received
- * @param size is the size of each data element
- * @param nmemb is the number of elements
- * @param data is a pointer to a string where the received data will be stored
- * @return Total size of the data received
+/** @brief Destructor, stops the request engine while the caches and tokens its callbacks use still exist
  */
-size_t SpotifyAPI::WriteCallback(void *contents, size_t size, size_t nmemb, string *data) {
-    size_t totalSize = size * nmemb;
-    //static callback function to write received data to a string
-    data->append(static_cast<char*>(contents), totalSize);
-    return totalSize;
+SpotifyAPI::~SpotifyAPI() {
+    requestEngine.stop();
+}
+/** @brief URL encodes a string
+ * @param value the string to encode
+ * @return the encoded string
+ */
+string SpotifyAPI::escape(const string& value) {
+    char* escaped = curl_easy_escape(nullptr, value.c_str(), static_cast<int>(value.length()));
+    string result = escaped ? escaped : "";
+    curl_free(escaped);
+    return result;
+}
+/** @brief picks the accounts service to authorize with
+ * @param accountsUrl the url given to the constructor, may be empty
+ * @return accountsUrl, else the SPOTIFY_ACCOUNTS_URL environment variable, else the real service
+ */
+string SpotifyAPI::resolveAccountsUrl(const string& accountsUrl) {
+    if (!accountsUrl.empty()) {
+        return accountsUrl;
+    }
+    const char* overridden = getenv("SPOTIFY_ACCOUNTS_URL");
+    return (overridden && *overridden) ? overridden : "https://accounts.spotify.com";
 }
 /** @brief private method to authenticate with Spotify and get an access token
  * @param base64 code to be entered (from doing echo ...:... | base64)
  * @return accessToken to be used to gain access to spotify account
  */
 string SpotifyAPI::getSpotifyAccessToken(const string& base64) {
-    CURL* curl;
-    CURLcode res;
-    string readBuffer;
     string accessToken;
 
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl = curl_easy_init();
-    if(curl){
-        string authHeader = "Authorization: Basic " + base64;
-
-        struct curl_slist *headers = nullptr;
-        headers = curl_slist_append(headers, authHeader.c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/x-www-form-urlencoded");
+    HttpRequest request;
+    request.method = "POST";
+    request.url = accountsUrl + "/api/token";
+    request.headers = {"Authorization: Basic " + base64, "Content-Type: application/x-www-form-urlencoded"};
+    request.body = "grant_type=client_credentials";
 
-        curl_easy_setopt(curl, CURLOPT_URL, "https://accounts.spotify.com/api/token");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "grant_type=client_credentials");
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-        
-        res = curl_easy_perform(curl);
-        if(res == CURLE_OK) {
-            auto json = json::parse(readBuffer);
-            accessToken = json["access_token"].get<string>();
-        }
-        else {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
-        }
-
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+    HttpResponse response = curlPool.perform(request);
+    if(response.ok()) {
+        auto json = json::parse(response.body);
+        accessToken = json["access_token"].get<string>();
+    }
+    else {
+        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(response.result) << endl;
     }
-    curl_global_cleanup();
     return accessToken;
 }
 
-/** @brief Getter method for the access token
- * @return the access token used for authentication (Auth 2.)o
+/** @brief Getter method for the access token, safe to call from any thread
+ *  Long lived callers should call it for every request rather than keep a copy, since the user
+ *  token is replaced whenever it is refreshed.
+ * @return the user access token, or the client credentials token before the user has authorized
  */
 string SpotifyAPI::getAccessToken(){
+    string token = tokens.getAccessToken();
+    if (!token.empty()) {
+        return token;
+    }
+    lock_guard<mutex> lock(clientTokenMutex);
+    if (this->accessToken.empty()) {
+        this->accessToken = getSpotifyAccessToken(base64Cred);
+    }
     return this->accessToken;
 }
-/** @brief getter method returns current volume percent on spotify instance
- * @return volumePercent
+/** @brief getter method for the token store counters
+ * @return one line summary of where the token came from and its refreshes
+ */
+string SpotifyAPI::getTokenStats() const {
+    return tokens.getStatsReport();
+}
+/** @brief getter method for the connection pool counters
+ * @return one line summary of requests sent and connections reused
+ */
+string SpotifyAPI::getConnectionStats() const {
+    return curlPool.getStatsReport();
+}
+/** @brief getter method for the track cache counters
+ * @return one line summary of hits, misses and evictions
+ */
+string SpotifyAPI::getCacheStats() const {
+    return trackCache.getStatsReport();
+}
+/** @brief getter method for the conditional request counters of this run
+ * @return one line summary of 304 responses, skipped playlists and what they saved
  */
-int SpotifyAPI::getVolumePercent(){
-    return this->volumePercent;
+string SpotifyAPI::getResponseCacheStats() const {
+    return responseCache.getStatsReport();
 }
 
 /** @brief public method to fetch track details using the Spotify Web API
@@ -93,159 +125,398 @@ int SpotifyAPI::getVolumePercent(){
  */
 
 string SpotifyAPI::getTrackDetails(const string& accessToken, const string& trackId) {
-    CURL* curl;
-    CURLcode res;
-    string readBuffer;
-
-    curl = curl_easy_init();
-    if(curl) {
-        string authHeader = "Authorization: Bearer " + accessToken;
-
-        struct curl_slist *headers = nullptr;
-        headers = curl_slist_append(headers, authHeader.c_str());
-
-        string url = "https://api.spotify.com/v1/tracks/" + trackId;
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+    return getTrackDetailsAsync(accessToken, trackId).get().body;
+}
+/** @brief public method to fetch a track as a typed record
+ * @param accessToken used for authentication
+ * @param trackId used to isolate which song's details are being searched
+ * @return the track, with an empty id if the request failed
+ */
+Track SpotifyAPI::getTrack(const string& accessToken, const string& trackId) {
+    Track track;
+    TrackId id = TrackId::fromBase62(trackId);
+    if (trackCache.lookup(id, track)) {
+        return track;
+    }
 
-        res = curl_easy_perform(curl);
-        if(res == CURLE_OK) {
-            //cout << "Track Details: " << readBuffer << endl;
-        }
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+    HttpResponse response = getTrackDetailsAsync(accessToken, trackId).get();
+    auto details = json::parse(response.body, nullptr, false);
+    if (!response.ok() || details.is_discarded() || !details.is_object()) {
+        return Track();
     }
-    return readBuffer;
+    track = details.get<Track>();
+    trackCache.store(id, track);
+    return track;
 }
 /** @brief public method to fetch playlist details using the Spotify Web API
  * @param accessToken used for authentication
  * @param playlistId used to isolate which playlist's details are being searched
+ * @param fields projection of the playlist object to download, Full downloads everything
  * @return readBuffer variable which stores metadata on playlist
  */
-string SpotifyAPI::getPlaylistDetails(const string& accessToken, const string& playlistId) {
-    CURL* curl;
-    CURLcode res;
-    string readBuffer;
-
-    curl = curl_easy_init();
-    if(curl) {
-        string authHeader = "Authorization: Bearer " + accessToken;
-
-        struct curl_slist *headers = nullptr;
-        headers = curl_slist_append(headers, authHeader.c_str());
-
-        string url = "https://api.spotify.com/v1/playlists/" + playlistId;
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        res = curl_easy_perform(curl);
-        if(res == CURLE_OK) {
-            //cout << "Playlist Details: " << readBuffer << endl;
-        }
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+string SpotifyAPI::getPlaylistDetails(const string& accessToken, const string& playlistId, PlaylistFields fields) {
+    return getPlaylistDetailsAsync(accessToken, playlistId, fields).get().body;
+}
+/** @brief builds the fields= query parameter for a projection
+ * @param fields the projection
+ * @param prefix path of the paging object inside the response, "tracks." for a playlist object
+ *        and empty for a page from the playlist tracks endpoint
+ * @return the parameter without its separator, empty for Full
+ */
+string SpotifyAPI::fieldsParameter(PlaylistFields fields, const string& prefix) {
+    string item;
+    switch (fields) {
+    case PlaylistFields::IdsOnly:
+        item = "track(id)";
+        break;
+    case PlaylistFields::DisplayRow:
+        item = "track(id,name,artists(name),album(images))";
+        break;
+    case PlaylistFields::Full:
+        return "";
     }
-    return readBuffer;
+    string projection = prefix + "total," + prefix + "next," + prefix + "items(" + item + ")";
+    //a playlist object also needs its own id and snapshot next to the tracks
+    if (!prefix.empty()) {
+        projection = "id,snapshot_id," + projection;
+    }
+    return "fields=" + escape(projection);
+}
+/** @brief getter method for the number of response body bytes received so far
+ * @return bytes received over every request
+ */
+size_t SpotifyAPI::getBytesReceived() const {
+    return curlPool.getBytesReceived();
+}
+/** @brief getter method for the number of requests completed so far
+ * @return requests completed over every connection
+ */
+size_t SpotifyAPI::getRequestCount() const {
+    return curlPool.getRequestCount();
 }
 /** @brief extracts playlist's ID using the playlist url
+ *  Links with or without a scheme, a locale path (/intl-xx/), a query, a fragment or a trailing slash,
+ *  and spotify:playlist: uris all give the same ID, so the same playlist is never fetched twice.
  * @param url The Spotify playlist URL from which to extract the playlist ID.
  * @return The extracted playlist ID if found, otherwise an empty string.
  */
 string SpotifyAPI::extractPlaylistID(const string& url){
-    string prefix = "https://open.spotify.com/playlist/";
-    auto starting = url.find(prefix);
+    string uriPrefix = "spotify:playlist:";
+    string pathPrefix = "/playlist/";
+    size_t starting;
 
-    if(starting == string::npos){
+    if(url.find(uriPrefix) != string::npos){
+        starting = url.find(uriPrefix) + uriPrefix.length();
+    }
+    else if(url.find("open.spotify.com") != string::npos && url.find(pathPrefix) != string::npos){
+        starting = url.find(pathPrefix) + pathPrefix.length(); // moves start to end of the prefix
+    }
+    else{
         return ""; //prefix substring was not found
     }
 
-    starting += prefix.length(); // moves start to end of the prefix
-
-    auto ending = url.find('?', starting);
-    if(ending == string::npos){
-        ending = url.length();
+    //a playlist ID is base62, so it ends at the first character that is not a letter or digit
+    auto ending = starting;
+    while(ending < url.length() && isalnum(static_cast<unsigned char>(url[ending]))){
+        ending++;
     }
     return url.substr(starting, ending-starting);
 }
 
+/** @brief extracts the track IDs from a playlist object or from one page of its tracks
+ * @param playlistJson JSON string of a playlist, or of a page returned by the playlist tracks endpoint
+ * @return the IDs of the tracks in the order they appear, local tracks without an ID are skipped
+ */
 vector<string> SpotifyAPI::extractTrackIDS(string& playlistJson){
-    auto playlist = json::parse(playlistJson);
+    //streamed with a SAX handler, the full playlist is never built as a json tree
     vector<string> trackIDs;
-    
-    if (playlist.contains("tracks") && playlist["tracks"].contains("items")) {
-        for (const auto& item : playlist["tracks"]["items"]) {
-            if (item.contains("track") && item["track"].contains("id") && !item["track"]["id"].is_null()) {
-                std::string trackId = item["track"]["id"];
-                trackIDs.push_back(trackId);
+    TrackIdExtractor::extract(playlistJson, trackIDs);
+    return trackIDs;
+}
+/** @brief reads every track ID of a playlist, following its pages
+ *  The playlist's snapshot_id is checked first, if it matches the snapshot stored by an earlier run the
+ *  stored IDs are returned without reading any page. Otherwise the first page gives the total, after
+ *  which all remaining pages are requested at once.
+ * @param accessToken used for authentication
+ * @param playlistId ID of the playlist to read
+ * @param fields projection of each page, IdsOnly is enough to read the IDs
+ * @param onPage optional, called with the offset and IDs of each page as soon as it arrives;
+ *        it runs on the request engine thread and must not block
+ * @param callback called on the request engine thread with every track ID in playlist order, in their compact
+ *        16 byte form, complete is false if a page could not be read even after retrying
+ */
+void SpotifyAPI::getPlaylistTrackIDsAsync(const string& accessToken, const string& playlistId, PlaylistFields fields,
+                                          function<void(PlaylistTrackIds)> callback,
+                                          function<void(size_t, const vector<TrackId>&)> onPage) {
+    //state shared by the callbacks of every page of this playlist
+    struct PagedRead {
+        mutex pagesMutex;
+        vector<vector<TrackId>> pages;
+        size_t remaining = 0;
+        bool failed = false; //a page could not be read, so the result is not stored
+        size_t bytes = 0;
+        chrono::steady_clock::time_point started;
+        string snapshot; //snapshot_id the pages belong to, empty if unknown
+        function<void(PlaylistTrackIds)> callback;
+        function<void(size_t, const vector<TrackId>&)> onPage;
+        function<void(const PagedRead&, const vector<TrackId>&)> onComplete; //called with the lock held
+
+        void start(size_t pageCount) {
+            lock_guard<mutex> lock(pagesMutex);
+            pages.resize(pageCount);
+            remaining = pageCount;
+        }
+        void store(size_t index, vector<TrackId> ids) {
+            if (onPage) {
+                onPage(index * maxTracksPerPage, ids);
+            }
+            PlaylistTrackIds read;
+            {
+                lock_guard<mutex> lock(pagesMutex);
+                pages[index] = move(ids);
+                if (--remaining != 0) {
+                    return;
+                }
+                for (auto& pageIds : pages) {
+                    read.ids.insert(read.ids.end(), pageIds.begin(), pageIds.end());
+                }
+                if (onComplete && !failed) {
+                    onComplete(*this, read.ids);
+                }
+                read.complete = !failed;
             }
+            //the caller may start its next requests from here, so the lock is released first
+            callback(move(read));
         }
+    };
+    auto read = make_shared<PagedRead>();
+    read->callback = move(callback);
+    read->onPage = move(onPage);
+
+    string pageUrl = "https://api.spotify.com/v1/playlists/" + playlistId + "/tracks?limit=" + to_string(maxTracksPerPage) + "&";
+    string projection = fieldsParameter(fields, "");
+    if (!projection.empty()) {
+        pageUrl += projection + "&";
     }
-    return trackIDs;
+    pageUrl += "offset=";
+    auto pageIds = [read](HttpResponse& response, size_t* total) {
+        vector<TrackId> ids;
+        if (!response.ok() || response.status != 200) {
+            cerr << "Could not read a playlist page: " << describeFailure(response) << endl;
+            lock_guard<mutex> lock(read->pagesMutex);
+            read->failed = true;
+        }
+        else {
+            TrackIdExtractor::extract(response.body, ids, total);
+            lock_guard<mutex> lock(read->pagesMutex);
+            read->bytes += response.body.length();
+        }
+        return ids;
+    };
+    auto readPages = [this, read, pageUrl, accessToken, pageIds]() {
+        read->started = chrono::steady_clock::now();
+        conditionalGet(pageUrl + "0", accessToken, [this, read, pageUrl, accessToken, pageIds](HttpResponse response) {
+            //the first page is read once for both its IDs and the playlist total
+            size_t total = 0;
+            vector<TrackId> firstIds = pageIds(response, &total);
+            size_t pageCount = max<size_t>(1, (total + maxTracksPerPage - 1) / maxTracksPerPage);
+            read->start(pageCount);
+            //the remaining pages are independent, so they are all requested before any of them returns
+            for (size_t index = 1; index < pageCount; index++) {
+                conditionalGet(pageUrl + to_string(index * maxTracksPerPage), accessToken,
+                               [read, index, pageIds](HttpResponse pageResponse) {
+                    read->store(index, pageIds(pageResponse, nullptr));
+                });
+            }
+            read->store(0, move(firstIds));
+        });
+    };
+
+    //the IDs of this snapshot are stored for the next run, 22 base62 characters each
+    string snapshotKey = "snapshot:" + playlistId;
+    read->onComplete = [this, snapshotKey](const PagedRead& done, const vector<TrackId>& ids) {
+        if (done.snapshot.empty()) {
+            return;
+        }
+        ResponseCache::Entry entry;
+        entry.tag = done.snapshot;
+        entry.body.reserve(ids.size() * TrackId::base62Length);
+        for (const auto& id : ids) {
+            entry.body += id.toBase62();
+        }
+        entry.bytes = done.bytes;
+        entry.seconds = chrono::duration<double>(chrono::steady_clock::now() - done.started).count();
+        responseCache.store(snapshotKey, entry);
+    };
+
+    string snapshotUrl = "https://api.spotify.com/v1/playlists/" + playlistId + "?fields=snapshot_id";
+    requestEngine.submit(apiRequest("GET", snapshotUrl, accessToken), [this, read, snapshotKey, readPages](HttpResponse response) {
+        if (response.ok() && response.status == 200) {
+            auto snapshot = json::parse(response.body, nullptr, false);
+            if (!snapshot.is_discarded() && snapshot.is_object()) {
+                read->snapshot = stringField(snapshot, "snapshot_id");
+            }
+        }
+
+        ResponseCache::Entry stored;
+        if (read->snapshot.empty() || !responseCache.lookup(snapshotKey, stored) || stored.tag != read->snapshot) {
+            readPages();
+            return;
+        }
+        //unchanged since the stored snapshot, the stored IDs are handed out page by page
+        responseCache.recordSkipped(stored);
+        vector<TrackId> ids;
+        ids.reserve(stored.body.length() / TrackId::base62Length);
+        for (size_t start = 0; start + TrackId::base62Length <= stored.body.length(); start += TrackId::base62Length) {
+            ids.push_back(TrackId::fromBase62(stored.body.substr(start, TrackId::base62Length)));
+        }
+        read->onComplete = nullptr;
+        size_t pageCount = max<size_t>(1, (ids.size() + maxTracksPerPage - 1) / maxTracksPerPage);
+        read->start(pageCount);
+        for (size_t index = 0; index < pageCount; index++) {
+            size_t begin = min(index * maxTracksPerPage, ids.size());
+            size_t end = min(begin + maxTracksPerPage, ids.size());
+            read->store(index, vector<TrackId>(ids.begin() + begin, ids.begin() + end));
+        }
+    });
 }
-/** @brief downloads the album cover for the desired track
- * @param trackDetailsJson JSON string which contains the track details
- * @param trackId ID of track
- * @param outputPath Path where image is saved
+/** @brief fetches the details of many tracks through the several tracks endpoint
+ *  Tracks found in the local cache are not requested, every chunk is requested at once.
+ * @param accessToken used for authentication
+ * @param trackIds IDs of the tracks, any number of them
+ * @param callback called on the request engine thread once every chunk has been read, with false if a chunk
+ *        failed even after retrying, and the tracks in the order of trackIds, tracks unknown to Spotify left out
  */
-void SpotifyAPI::downloadTrackImg(const string& trackDetailsJson, const string& trackID, const QString& outputPath){
-
-    string imageURL;
-    //parse through the JSON string to get the url aray containing the image
-    auto trackDetails = json::parse(trackDetailsJson);
-    if(trackDetails.contains("album") && trackDetails["album"].contains("images") && !trackDetails["album"]["images"].empty()) {
-        auto firstImage = trackDetails["album"]["images"][0];
-        if(firstImage.contains("url")) {
-            imageURL = firstImage["url"];
+void SpotifyAPI::getSeveralTracksAsync(const string& accessToken, const vector<TrackId>& trackIds,
+                                       function<void(bool, vector<Track>)> callback) {
+    //state shared by the callbacks of every chunk
+    struct SeveralRead {
+        mutex chunksMutex;
+        vector<TrackId> trackIds;
+        vector<Track> found;
+        vector<bool> cached;
+        unordered_map<TrackId, Track> fetched;
+        size_t remaining = 0;
+        bool failed = false;
+        function<void(bool, vector<Track>)> callback;
+
+        void finish() {
+            vector<Track> tracks;
+            tracks.reserve(trackIds.size());
+            for (size_t i = 0; i < trackIds.size(); i++) {
+                if (cached[i]) {
+                    tracks.push_back(move(found[i]));
+                    continue;
+                }
+                auto it = fetched.find(trackIds[i]);
+                if (it != fetched.end()) {
+                    tracks.push_back(it->second);
+                }
+            }
+            callback(!failed, move(tracks));
+        }
+    };
+    auto read = make_shared<SeveralRead>();
+    read->trackIds = trackIds;
+    read->found.resize(trackIds.size());
+    read->cached.assign(trackIds.size(), false);
+    read->callback = move(callback);
+    vector<TrackId> missing;
+    for (size_t i = 0; i < trackIds.size(); i++) {
+        read->cached[i] = trackCache.lookup(trackIds[i], read->found[i]);
+        if (!read->cached[i]) {
+            missing.push_back(trackIds[i]);
         }
     }
+    read->fetched.reserve(missing.size());
+    read->remaining = (missing.size() + maxTracksPerRequest - 1) / maxTracksPerRequest;
+    if (read->remaining == 0) {
+        read->finish();
+        return;
+    }
 
-    QNetworkAccessManager manager;
-    QNetworkRequest request(QUrl(QString::fromStdString(imageURL)));
-    QNetworkReply* reply = manager.get(request);
-
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();//waits for download to finish
-
-    //checks if no errors occured
-    if(reply->error() == QNetworkReply::NoError) {
-        //save file as (trackID)img.png
-        QFile file(outputPath + "/" + QString::fromStdString(trackID) + ".png");
-        if(file.open(QIODevice::WriteOnly)) {
-            file.write(reply->readAll());
-            file.close();
-            //qDebug() << "Downloaded and saved:" << filename;
-        } else {
-            //qWarning() << "Could not open file for writing:" << filename;
+    //the endpoint accepts at most 50 ids
+    for (size_t start = 0; start < missing.size(); start += maxTracksPerRequest) {
+        size_t end = min(start + maxTracksPerRequest, missing.size());
+        string ids;
+        for (size_t i = start; i < end; i++) {
+            if (!ids.empty()) ids += ",";
+            ids += missing[i].toBase62();
         }
-    } else {
-        //qWarning() << "Failed to download image:" << reply->errorString();
+        submitRetrying(apiRequest("GET", "https://api.spotify.com/v1/tracks?ids=" + ids, accessToken),
+                       [this, read](HttpResponse response) {
+            auto chunk = json::parse(response.body, nullptr, false);
+            bool ok = response.ok() && response.status == 200 && chunk.is_object() && chunk.contains("tracks")
+                      && chunk["tracks"].is_array();
+            vector<Track> tracks;
+            if (!ok) {
+                cerr << "Could not read a chunk of tracks: " << describeFailure(response) << endl;
+            }
+            else {
+                for (const auto& item : chunk["tracks"]) {
+                    if (!item.is_null()) {
+                        tracks.push_back(item.get<Track>());
+                        trackCache.store(TrackId::fromBase62(tracks.back().id), tracks.back());
+                    }
+                }
+            }
+            lock_guard<mutex> lock(read->chunksMutex);
+            read->failed = read->failed || !ok;
+            for (Track& track : tracks) {
+                TrackId id = TrackId::fromBase62(track.id);
+                read->fetched[id] = move(track);
+            }
+            if (--read->remaining == 0) {
+                read->finish();
+            }
+        });
     }
-    reply->deleteLater();
 }
-/** @brief method used to create playlists
+/** @brief method used to create playlists, the user must have authorized the app already
  * @param playlistName string which contains the name of the created playlist
- * @param clientId string containing ID of client
  * @return id string containing id of playlist
  */
-string SpotifyAPI::createPlaylist(const string& clientID, const string&playlistName){
-    CURL *curl = curl_easy_init();
-    string redirectUri = "http://localhost:3000";
-    string encodedRedirectUri = curl_easy_escape(curl, redirectUri.c_str(), redirectUri.length());
-    string scope = "playlist-modify-private%20playlist-modify-public%20user-read-playback-state%20user-modify-playback-state%20user-read-currently-playing";
+string SpotifyAPI::createPlaylist(const string&playlistName){
+    if (!ensureUserToken()) {
+        cerr << "Not authorized, the playlist was not created" << endl;
+        return "";
+    }
 
-    string authUrl = "https://accounts.spotify.com/authorize?client_id=" + clientID +
-                     "&response_type=code&redirect_uri=" + encodedRedirectUri + "&scope=" + scope;
+    string id;
+    //cout << "createplaylist: " + accessToken << endl;
+    HttpRequest request;
+    request.method = "POST";
+    request.url = "https://api.spotify.com/v1/users/" + getUserID() + "/playlists";
+    request.headers = {"Authorization: Bearer " + getAccessToken(), "Content-Type: application/json"};
+    request.body = "{\"name\":\"" + playlistName + "\", \"public\":false}";
+
+    HttpResponse response = curlPool.perform(request);
+    //this runs as a startup step on a worker thread, so an error response must not throw
+    if(response.ok() && response.status == 201) {
+        //cout << "Playlist Created: " << response.body << endl;
+        auto created = json::parse(response.body, nullptr, false);
+        if (created.is_object()) {
+            id = stringField(created, "id");
+        }
+    }
+    if (id.empty()) {
+        cerr << "Failed to create playlist: " << describeFailure(response) << endl;
+    }
+    return id;
+}  
+/** @brief asks the user to open the authorize page and paste the code, used when the redirect
+ *  cannot be captured, must be called on the GUI thread
+ * @param clientID string containing ID of client
+ * @return true if the user is authorized afterwards
+ */
+bool SpotifyAPI::authorizeWithPastedCode(const string& clientID){
+    string redirectUri = "http://localhost:3000";
+    string encodedRedirectUri = escape(redirectUri);
+    string authUrl = getAuthorizeUrl(clientID, redirectUri);
 
     bool ok;
     cout << authUrl << endl;
-    
+
     QString code = QInputDialog::getText(nullptr, "Please visit the following webiste(printed to console) and enter the code to authorize playlist creation." ,
                     "Code:", QLineEdit::Normal, QDir::home().dirName(), &ok);
 
@@ -253,103 +524,103 @@ string SpotifyAPI::createPlaylist(const string& clientID, const string&playlistN
     if (ok && !code.isEmpty()) {
         string exchangedCode = exchangeAuthCodeForAccessCode(code.toStdString(), encodedRedirectUri);
     }
-
-    string id;
-    if (curl) {
-        //cout << "createplaylist: " + accessToken << endl;
-        string url = "https://api.spotify.com/v1/users/" + getUserID() + "/playlists";
-        string post = "{\"name\":\"" + playlistName + "\", \"public\":false}";
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + accessToken).c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post.c_str());
-
-        string readBuffer;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-        
-        CURLcode res = curl_easy_perform(curl);
-        if(res == CURLE_OK) {
-            //cout << "Playlist Created: " << readBuffer << endl;
-            auto json = json::parse(readBuffer);
-            id = json["id"].get<string>();
-        }
-        else{
-        //cout << "Failed to create playlist" << curl_easy_strerror(res) << endl;
-        }
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-    }
-    return id;
-}  
+    return hasUserToken();
+}
 /** @brief method used to generate access code using Authorization code
  * @param code string containing Authorization code
  * @param redirectUri string containing redirect URI
  * @return readBuffer string containing access code
  */
 string SpotifyAPI::exchangeAuthCodeForAccessCode(const string& code, const string& redirectUri){
-    CURL* curl = curl_easy_init();
-    string readBuffer;
-    string authHeader = "Authorization: Basic " + base64Cred;
-    string post = "grant_type=authorization_code&code=" + code + "&redirect_uri=" + redirectUri;
-
-    if (curl) {
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, authHeader.c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/x-www-form-urlencoded");
-
-        curl_easy_setopt(curl, CURLOPT_URL, "https://accounts.spotify.com/api/token");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        CURLcode res = curl_easy_perform(curl);
-        if(res == CURLE_OK) {
-            auto json = json::parse(readBuffer);
-            this->accessToken = json["access_token"].get<string>();
+    HttpRequest request;
+    request.method = "POST";
+    request.url = accountsUrl + "/api/token";
+    request.headers = {"Authorization: Basic " + base64Cred, "Content-Type: application/x-www-form-urlencoded"};
+    request.body = "grant_type=authorization_code&code=" + code + "&redirect_uri=" + redirectUri;
+
+    HttpResponse response = curlPool.perform(request);
+    if(response.ok()) {
+        //keeps the refresh token too, so later sessions do not have to authorize again
+        if (!tokens.publish(response.body)) {
+            cerr << "Authorization failed: " << response.body << endl;
         }
-        else {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
-        }
-
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+    }
+    else {
+        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(response.result) << endl;
     }
 
-    return readBuffer; //contains the access token in JSON
+    return response.body; //contains the access token in JSON
+}
+/** @brief asynchronous version of exchangeAuthCodeForAccessCode, used with AuthorizationListener
+ * @param code string containing Authorization code
+ * @param redirectUri redirect URI sent with the authorize request, not yet URL encoded
+ * @param callback called on the request engine thread once the token is published or the exchange failed
+ */
+void SpotifyAPI::exchangeAuthCodeAsync(const string& code, const string& redirectUri, function<void(bool)> callback) {
+    HttpRequest request;
+    request.method = "POST";
+    request.url = accountsUrl + "/api/token";
+    request.headers = {"Authorization: Basic " + base64Cred, "Content-Type: application/x-www-form-urlencoded"};
+    request.body = "grant_type=authorization_code&code=" + escape(code) + "&redirect_uri=" + escape(redirectUri);
+
+    requestEngine.submit(request, [this, callback](HttpResponse response) {
+        bool ok = response.ok() && response.status == 200 && tokens.publish(response.body);
+        if (!ok) {
+            cerr << "Authorization failed: " << (response.ok() ? response.body : string(curl_easy_strerror(response.result))) << endl;
+        }
+        callback(ok);
+    });
+}
+/** @brief builds the url the user opens to authorize the app
+ * @param clientID string containing ID of client
+ * @param redirectUri where the accounts service sends the browser back to, not yet URL encoded
+ * @param state value the redirect has to carry back, empty for none
+ * @return the url
+ */
+string SpotifyAPI::getAuthorizeUrl(const string& clientID, const string& redirectUri, const string& state) const {
+    string scope = "playlist-modify-private%20playlist-modify-public%20user-read-playback-state%20user-modify-playback-state%20user-read-currently-playing";
+    string url = accountsUrl + "/authorize?client_id=" + clientID + "&response_type=code&redirect_uri=" +
+                 escape(redirectUri) + "&scope=" + scope;
+    if (!state.empty()) {
+        url += "&state=" + escape(state);
+    }
+    return url;
+}
+/** @brief checks whether a user token can be used right away
+ * @return true if the user has authorized the app and the token has not expired
+ */
+bool SpotifyAPI::hasUserToken() const {
+    return tokens.hasValidToken();
+}
+/** @brief sets what to do once the stored authorization has been revoked and refreshing stopped
+ * @param handler called on the thread that tried to refresh, it must not block
+ */
+void SpotifyAPI::setAuthorizationLostHandler(function<void()> handler) {
+    tokens.setRevokedHandler(move(handler));
+}
+/** @brief makes sure a user token can be used, refreshing a stored one if it has expired
+ * @return true if a user token is valid, blocks while refreshing
+ */
+bool SpotifyAPI::ensureUserToken() {
+    return tokens.hasValidToken() || tokens.refresh();
+}
+/** @brief opens the pooled connection to the Web API and pages in the track cache, so the first
+ *  requests and lookups of the session do not pay for the TLS handshake or page faults
+ */
+void SpotifyAPI::warmUp() {
+    //the request is not authorized, the 401 it gets still leaves the connection open in the pool
+    future<HttpResponse> connection = requestEngine.submit(apiRequest("GET", "https://api.spotify.com/v1/", ""));
+    trackCache.prefetch();
+    connection.wait();
 }
 /** @brief getter method used to return the user ID
  * @return userID string containing the user ID
  */
 string SpotifyAPI::getUserID(){
-    CURL* curl = curl_easy_init();
-    string readBuffer;
-    string userID;
-    if (curl) {
-    struct curl_slist* headers = nullptr;
-    string authHeader = "Authorization: Bearer " + accessToken;
-    headers = curl_slist_append(headers, authHeader.c_str());
-
-    curl_easy_setopt(curl, CURLOPT_URL, "https://api.spotify.com/v1/me");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);  // WriteCallback function as shown earlier
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
-    }
-
-    auto jsonResponse = json::parse(readBuffer);
-    userID = jsonResponse["id"];
-    //cout << "UserID: " << userID << endl;
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
+    //the user does not change during a session, so it is only requested once
+    lock_guard<mutex> lock(userIDMutex);
+    if (userID.empty()) {
+        userID = getUserIDAsync().get();
     }
     return userID;
 }
@@ -357,65 +628,31 @@ string SpotifyAPI::getUserID(){
  * @return id string containing the device ID
  */
 string SpotifyAPI::getDeviceID(){
-    CURL* curl = curl_easy_init();
-    string readBuffer;
-    string id;
-    if (curl) {
-    struct curl_slist* headers = nullptr;
-    string authHeader = "Authorization: Bearer " + accessToken;
-    headers = curl_slist_append(headers, authHeader.c_str());
-
-    curl_easy_setopt(curl, CURLOPT_URL, "https://api.spotify.com/v1/me/player/devices");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);  // WriteCallback function as shown earlier
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
-    }
-    else {
-        //cout << "Available Devices: " << readBuffer << endl;
-    }
-
-    auto deviceIdJson = json::parse(readBuffer);
-    for(const auto& device : deviceIdJson["devices"]){
-        id = device["id"].get<string>();
-        this->volumePercent = device["volume_percent"].get<int>();;
-    }
-    
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
-    }
-    //cout << "Id: " << id << endl;
-    return id;
+    return getDeviceIDAsync().get();
 }
 /** @brief getter method used to return the track which is currently playing
  * @param accessToken string containg access token
  * @return readBuffer string containing the track which is currently playing on spotify
  */
 string SpotifyAPI::getCurrentTrack(const string& accessToken){
-    CURL* curl = curl_easy_init();
-    string readBuffer;
-    if (curl) {
-    struct curl_slist* headers = nullptr;
-    string authHeader = "Authorization: Bearer " + accessToken;
-    headers = curl_slist_append(headers, authHeader.c_str());
-
-    curl_easy_setopt(curl, CURLOPT_URL, "https://api.spotify.com/v1/me/player/currently-playing");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);  // WriteCallback function as shown earlier
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
+    HttpResponse response = getCurrentTrackAsync(accessToken).get();
+    if (!response.ok()) {
+        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(response.result) << endl;
     }
-
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
+    return response.body;
+}
+/** @brief getter method used to return the playback state as a typed record
+ * @param accessToken string containg access token
+ * @return the playback state, hasTrack is false when nothing is playing
+ */
+CurrentlyPlaying SpotifyAPI::getCurrentlyPlaying(const string& accessToken){
+    //an empty body (204 No Content) means nothing is playing
+    string currentlyPlayingJson = getCurrentTrack(accessToken);
+    auto currentlyPlaying = json::parse(currentlyPlayingJson, nullptr, false);
+    if (currentlyPlaying.is_discarded() || !currentlyPlaying.is_object()) {
+        return CurrentlyPlaying();
     }
-    return readBuffer;
+    return currentlyPlaying.get<CurrentlyPlaying>();
 }
 /** @brief method used to add a track to the desired playlist
  * @param accessToken string containg access token
@@ -423,243 +660,273 @@ string SpotifyAPI::getCurrentTrack(const string& accessToken){
  * @param trackID string containing the id of the desired track to add to playlist
  */
 void SpotifyAPI::addTrackToPlaylist(const string& accessToken, const string& playlistID, const string& trackID) {
-    CURL* curl = curl_easy_init();
-    string readBuffer; // To store the response
-
-    if (curl) {
-        string url = "https://api.spotify.com/v1/playlists/" + playlistID + "/tracks";
-        string data = "{\"uris\": [\"" + trackID + "\"]}";
-
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + accessToken).c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        CURLcode res = curl_easy_perform(curl);
-        if(res != CURLE_OK) {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << '\n';
-        }
-        else {
-            cout << "Successfully added track to playlist." << endl;
-        }
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+    HttpResponse response = addTrackToPlaylistAsync(accessToken, playlistID, trackID).get();
+    if(!response.ok()) {
+        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(response.result) << '\n';
+    }
+    else {
+        cout << "Successfully added track to playlist." << endl;
     }
 }
-/** @brief method used to play a paused track
+/** @brief method used to add up to 100 tracks to the desired playlist in one request, without waiting for it
  * @param accessToken string containg access token
+ * @param playlistID string containing the id of the desired playlist
+ * @param uris spotify uris of the tracks, in the order they are inserted
+ * @param position index in the playlist where the first track is inserted
+ * @param callback called on the request engine thread with the snapshot id of the playlist after the write,
+ *        empty if the write failed
  */
-void SpotifyAPI::resumePlayback(const string& accessToken) {
-    CURL* curl = curl_easy_init();
-    string readBuffer; // To store the response
-
-    if (curl) {
-        // Set the endpoint URL, including the device ID if provided
-        string url = "https://api.spotify.com/v1/me/player/play";
-  
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        // Specify the PUT request method
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-
-        // Set the callback function to write the response
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        // Set the data structure to write the response to
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        // Prepare headers
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + accessToken).c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        // Perform the request
-        CURLcode res = curl_easy_perform(curl);
-
-        // Check for errors
-        if (res != CURLE_OK) {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << '\n';
-        } else {
-            cout << "Playback resumed successfully.\n";
+void SpotifyAPI::addTracksToPlaylistAsync(const string& accessToken, const string& playlistID, const vector<string>& uris,
+                                          int position, function<void(string)> callback) {
+    json bodyData = {{"uris", uris}, {"position", position}};
+    //a 429 is not applied, so sending the write again cannot insert the tracks twice
+    submitRetrying(apiRequest("POST", "https://api.spotify.com/v1/playlists/" + playlistID + "/tracks", accessToken, bodyData.dump()),
+                   [callback](HttpResponse response) {
+        auto result = json::parse(response.body, nullptr, false);
+        if (!response.ok() || response.status >= 300 || !result.is_object()) {
+            cerr << "Failed to add tracks to playlist: " << describeFailure(response) << endl;
+            callback("");
+            return;
         }
-
-        // Cleanup
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-    }
+        callback(stringField(result, "snapshot_id"));
+    });
 }
-/** @brief method used to play a scpeific track on spotify
+/** @brief builds a request to the Web API authorized with the given access token
+ * @param method HTTP method of the request
+ * @param url full url of the endpoint
  * @param accessToken string containg access token
- * @param trackID string containing the id of the desired track to play
+ * @param body JSON body of the request, empty for none
+ * @return the request ready to be submitted
  */
-void SpotifyAPI::playTrackOnSpotify(const string& accessToken, const string& trackID) {
-    CURL* curl = curl_easy_init();
-    string readBuffer; // To store the response
-
-    if(curl) {
-        // Set the endpoint URL
-        curl_easy_setopt(curl, CURLOPT_URL, "https://api.spotify.com/v1/me/player/play");
-        // Specify the PUT request method
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-
-        // Prepare the JSON body
-        json bodyData = json::object({{"uris", json::array({"spotify:track:" + trackID})}});
-        string jsonData = bodyData.dump();
-
-        // Set the POST fields
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonData.c_str());
-
-        // Set the callback function to write the response
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        // Set the data structure to write the response to
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        // Prepare headers
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + accessToken).c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        // Perform the request
-        CURLcode res = curl_easy_perform(curl);
-
-        // Check for errors
-        if(res != CURLE_OK) {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
-        }
-        else {
-            cout << "Playback started successfully." << endl;
+HttpRequest SpotifyAPI::apiRequest(const string& method, const string& url, const string& accessToken, const string& body) {
+    HttpRequest request;
+    request.method = method;
+    request.url = url;
+    request.headers = {"Authorization: Bearer " + accessToken};
+    if (method != "GET") {
+        request.headers.push_back("Content-Type: application/json");
+    }
+    request.body = body;
+    return request;
+}
+/** @brief submits a request, sending it again after the Retry-After delay while it is answered with 429
+ * @param request the request
+ * @param callback called on the request engine thread with the final response, it must not block
+ * @param retriesLeft how many more times a 429 is retried
+ * @param delay how long to wait before sending
+ */
+void SpotifyAPI::submitRetrying(const HttpRequest& request, function<void(HttpResponse)> callback, int retriesLeft,
+                                chrono::milliseconds delay) {
+    requestEngine.submit(request, [this, request, callback, retriesLeft](HttpResponse response) {
+        if (response.ok() && response.status == 429 && retriesLeft > 0) {
+            int delaySeconds = max(1, response.retryAfterSeconds);
+            cerr << "Rate limited, retrying in " << delaySeconds << " s: " << request.url << endl;
+            //the engine holds the retry until it is due, nothing waits for it meanwhile
+            submitRetrying(request, callback, retriesLeft - 1, chrono::seconds(delaySeconds));
+            return;
         }
-
-        // Cleanup
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+        callback(move(response));
+    }, delay);
+}
+/** @brief describes why a request failed, for the error messages
+ * @param response the response
+ * @return the curl error, or the HTTP status and body
+ */
+string SpotifyAPI::describeFailure(const HttpResponse& response) {
+    if (!response.ok()) {
+        return curl_easy_strerror(response.result);
     }
+    return "HTTP " + to_string(response.status) + (response.body.empty() ? string() : " " + response.body);
 }
-/** @brief method used to play desired playlist on spotify
- * @param accessToken string containg access token
- * @param playlistID string containing the id of the desired playlist
+/** @brief sends a GET with the ETag of the stored response, a 304 is answered with the stored body
+ *  A 200 response carrying an ETag replaces the stored one.
+ * @param url full url of the endpoint, also the key of the stored response
+ * @param accessToken used for authentication
+ * @param callback called on the request engine thread with the response, it must not block
  */
-void SpotifyAPI::playPlaylistOnSpotify(const string& accessToken, const string& playlistID) {
-    CURL* curl = curl_easy_init();
-    string readBuffer; // To store the response
-    string url = "https://api.spotify.com/v1/me/player/play";
-    if(curl) {
-        string data = "{\"context_uri\":\"" + playlistID + "\"}"; // Set the playlist to play
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT"); // Use PUT method
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
-
-        // Prepare headers
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + accessToken).c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        // Perform the request
-        CURLcode res = curl_easy_perform(curl);
+void SpotifyAPI::conditionalGet(const string& url, const string& accessToken, function<void(HttpResponse)> callback) {
+    HttpRequest request = apiRequest("GET", url, accessToken);
+    ResponseCache::Entry stored;
+    bool haveStored = responseCache.lookup(url, stored) && !stored.tag.empty();
+    if (haveStored) {
+        request.headers.push_back("If-None-Match: " + stored.tag);
+        responseCache.recordSent();
+    }
 
-        // Check for errors
-        if(res != CURLE_OK) {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
+    submitRetrying(request, [this, url, haveStored, stored, callback](HttpResponse response) {
+        if (response.ok() && response.status == 304 && haveStored) {
+            responseCache.recordNotModified(stored, response.seconds);
+            response.status = 200;
+            response.body = stored.body;
+            response.fromCache = true;
         }
-        else {
-            cout << "Playback started successfully." << endl;
+        else if (response.ok() && response.status == 200 && !response.etag.empty()) {
+            ResponseCache::Entry entry;
+            entry.tag = response.etag;
+            entry.body = response.body;
+            entry.bytes = response.body.length();
+            entry.seconds = response.seconds;
+            responseCache.store(url, entry);
         }
-
-        // Cleanup
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+        callback(move(response));
+    });
+}
+/** @brief future returning version of conditionalGet
+ * @param url full url of the endpoint, also the key of the stored response
+ * @param accessToken used for authentication
+ * @return future holding the response, with the stored body if the server answered 304
+ */
+future<HttpResponse> SpotifyAPI::conditionalGet(const string& url, const string& accessToken) {
+    auto promised = make_shared<promise<HttpResponse>>();
+    future<HttpResponse> result = promised->get_future();
+    conditionalGet(url, accessToken, [promised](HttpResponse response) { promised->set_value(move(response)); });
+    return result;
+}
+/** @brief asynchronous version of getTrackDetails
+ *  Tracks are kept by TrackCache, the conditional requests are left to playlists.
+ * @param accessToken used for authentication
+ * @param trackId used to isolate which song's details are being searched
+ * @return future holding the response, its body stores metadata on track
+ */
+future<HttpResponse> SpotifyAPI::getTrackDetailsAsync(const string& accessToken, const string& trackId) {
+    return requestEngine.submit(apiRequest("GET", "https://api.spotify.com/v1/tracks/" + trackId, accessToken));
+}
+/** @brief asynchronous version of getPlaylistDetails
+ * @param accessToken used for authentication
+ * @param playlistId used to isolate which playlist's details are being searched
+ * @param fields projection of the playlist object to download, Full downloads everything
+ * @return future holding the response, its body stores metadata on playlist
+ */
+future<HttpResponse> SpotifyAPI::getPlaylistDetailsAsync(const string& accessToken, const string& playlistId, PlaylistFields fields) {
+    string url = "https://api.spotify.com/v1/playlists/" + playlistId;
+    string projection = fieldsParameter(fields, "tracks.");
+    if (!projection.empty()) {
+        url += "?" + projection;
     }
+    return conditionalGet(url, accessToken);
 }
-/** @brief method used to pause the track that is currently playing
- * @param accessToken string containg access token
+/** @brief asynchronous version of getUserID
+ * @return future holding the user ID, it is parsed by the thread that calls get()
  */
-void SpotifyAPI::pauseTrackOnSpotify(const string& accessToken) {
-    CURL* curl = curl_easy_init();
-    string readBuffer; // To store the response
-
-    if(curl) {
-        // Set the endpoint URL for pausing playback
-        curl_easy_setopt(curl, CURLOPT_URL, "https://api.spotify.com/v1/me/player/pause");
-        // Specify the PUT request method
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-
-        // Set the callback function to write the response
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        // Set the data structure to write the response to
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        // Prepare headers
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + accessToken).c_str());
-        headers = curl_slist_append(headers, "Content-Type: application/json"); // Content-Type may be set for consistency
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        // Perform the request
-        CURLcode res = curl_easy_perform(curl);
+future<string> SpotifyAPI::getUserIDAsync() {
+    auto pending = make_shared<future<HttpResponse>>(
+        requestEngine.submit(apiRequest("GET", "https://api.spotify.com/v1/me", getAccessToken())));
+    return async(launch::deferred, [pending]() {
+        HttpResponse response = pending->get();
+        if (!response.ok()) {
+            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(response.result) << endl;
+        }
 
-        // Check for errors
-        if(res != CURLE_OK) {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
+        auto jsonResponse = json::parse(response.body, nullptr, false);
+        string userID = jsonResponse.is_object() ? stringField(jsonResponse, "id") : string();
+        //cout << "UserID: " << userID << endl;
+        return userID;
+    });
+}
+/** @brief asynchronous version of getDeviceID
+ *  The active device is picked, or the first one that accepts commands if none is active.
+ * @return future holding the device ID, it is parsed by the thread that calls get()
+ */
+future<string> SpotifyAPI::getDeviceIDAsync() {
+    auto pending = make_shared<future<HttpResponse>>(
+        requestEngine.submit(apiRequest("GET", "https://api.spotify.com/v1/me/player/devices", getAccessToken())));
+    return async(launch::deferred, [this, pending]() {
+        vector<Device> devices;
+        if (!parseDevices(pending->get(), devices)) {
+            return string();
         }
-        else {
-            cout << "Playback paused successfully." << endl;
+        const Device* chosen = nullptr;
+        for (const Device& device : devices) {
+            if (device.canTarget() && (!chosen || (device.isActive && !chosen->isActive))) {
+                chosen = &device;
+            }
         }
-
-        // Cleanup
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+        if (!chosen) {
+            return string();
+        }
+        return chosen->id;
+    });
+}
+/** @brief lists the devices of the user, used by DeviceRegistry
+ * @param accessToken string containg access token
+ * @param callback called on the request engine thread with false if the request failed, it must not block
+ */
+void SpotifyAPI::getDevicesAsync(const string& accessToken, function<void(bool, vector<Device>)> callback) {
+    requestEngine.submit(apiRequest("GET", "https://api.spotify.com/v1/me/player/devices", accessToken),
+                         [callback](HttpResponse response) {
+        vector<Device> devices;
+        bool ok = parseDevices(response, devices);
+        callback(ok, move(devices));
+    });
+}
+/** @brief reads the response of the devices endpoint
+ * @param response the response
+ * @param devices receives the devices
+ * @return false if the request failed or the body is not a device list
+ */
+bool SpotifyAPI::parseDevices(const HttpResponse& response, vector<Device>& devices) {
+    if (!response.ok()) {
+        cerr << "curl_easy_perform() failed: " << curl_easy_strerror(response.result) << endl;
+        return false;
+    }
+    auto body = json::parse(response.body, nullptr, false);
+    if (response.status != 200 || !body.is_object() || !body.contains("devices") || !body["devices"].is_array()) {
+        cerr << "Could not list the devices: HTTP " << response.status << endl;
+        return false;
     }
+    devices = body["devices"].get<vector<Device>>();
+    return true;
 }
-/** @brief method used to set the volume on spotify
+/** @brief asynchronous version of getCurrentTrack
+ * @param accessToken string containg access token
+ * @return future holding the response, its body contains the track which is currently playing
+ */
+future<HttpResponse> SpotifyAPI::getCurrentTrackAsync(const string& accessToken) {
+    //the playback state endpoint returns the same fields as currently-playing, plus the device
+    return requestEngine.submit(apiRequest("GET", "https://api.spotify.com/v1/me/player", accessToken));
+}
+/** @brief asynchronous version of addTrackToPlaylist
+ * @param accessToken string containg access token
+ * @param playlistID string containing the id of the desired playlist
+ * @param trackID string containing the id of the desired track to add to playlist
+ * @return future holding the response
+ */
+future<HttpResponse> SpotifyAPI::addTrackToPlaylistAsync(const string& accessToken, const string& playlistID, const string& trackID) {
+    string data = "{\"uris\": [\"" + trackID + "\"]}";
+    return requestEngine.submit(apiRequest("POST", "https://api.spotify.com/v1/playlists/" + playlistID + "/tracks", accessToken, data));
+}
+/** @brief sets the volume of a device
  * @param accessToken string containg access token
  * @param volumePercent integer containg the desired level of volume
+ * @param deviceID device to set the volume of, empty for the active device
+ * @param callback called on the request engine thread with the response, it must not block
  */
-void SpotifyAPI::setVolume(const string& accessToken, int volumePercent) {
-    CURL* curl = curl_easy_init();
-    string readBuffer; // To store the response
-
-    if(curl) {
-        // Prepare the URL with the volume_percent query parameter
-        string url = "https://api.spotify.com/v1/me/player/volume?volume_percent=" + to_string(volumePercent);
-
-        // Set the endpoint URL
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        // Specify the PUT request method
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-
-        // Set the callback function to write the response
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        // Set the data structure to write the response to
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        // Prepare headers
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + accessToken).c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        // Perform the request
-        CURLcode res = curl_easy_perform(curl);
-
-        // Check for errors
-        if(res != CURLE_OK) {
-            cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << endl;
-        }
-        else {
-            cout << "Volume set successfully." << endl;
-        }
-
-        // Cleanup
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+void SpotifyAPI::setVolumeAsync(const string& accessToken, int volumePercent, const string& deviceID,
+                                function<void(HttpResponse)> callback) {
+    string url = "https://api.spotify.com/v1/me/player/volume?volume_percent=" + to_string(volumePercent);
+    if (!deviceID.empty()) {
+        url += "&device_id=" + escape(deviceID);
     }
-}
\ No newline at end of file
+    requestEngine.submit(apiRequest("PUT", url, accessToken), move(callback));
+}
+/** @brief sends one playback command, used by PlaybackCommandQueue
+ * @param accessToken string containg access token
+ * @param deviceID device to send the command to, empty for the active device
+ * @param command the command to send
+ * @param callback called on the request engine thread with the response, it must not block
+ */
+void SpotifyAPI::sendPlaybackCommandAsync(const string& accessToken, const string& deviceID, const PlaybackCommand& command,
+                                          function<void(HttpResponse)> callback) {
+    string url = "https://api.spotify.com/v1/me/player/" + string(command.kind == PlaybackCommand::Pause ? "pause" : "play");
+    if (!deviceID.empty()) {
+        url += "?device_id=" + escape(deviceID);
+    }
+    string body;
+    if (command.kind == PlaybackCommand::PlayTrack) {
+        body = json::object({{"uris", json::array({command.uri})}}).dump();
+    }
+    else if (command.kind == PlaybackCommand::PlayContext) {
+        body = json::object({{"context_uri", command.uri}}).dump();
+    }
+    requestEngine.submit(apiRequest("PUT", url, accessToken, body), move(callback));
+}
@@ -10,6 +10,14 @@
 #include <vector>
 #include "json.hpp"
 #include <curl/curl.h>
+#include "CurlPool.h"
+#include "RequestEngine.h"
+#include "SpotifyTypes.h"
+#include "TrackId.h"
+#include "TrackCache.h"
+#include "ResponseCache.h"
+#include "TokenManager.h"
+#include <future>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
@@ -20,37 +28,101 @@
 
 using namespace std;
 
+//projections of a playlist passed as the fields= parameter, smaller projections download less
+enum class PlaylistFields {
+    IdsOnly,    //only the track IDs and the paging information
+    DisplayRow, //what a track row shows: ID, name, artist names and album images
+    Full        //the whole object
+};
+
+//every track ID of a playlist, complete is false if a page could not be read
+struct PlaylistTrackIds {
+    vector<TrackId> ids;
+    bool complete = false;
+};
+
 class SpotifyAPI {
 public:
     //initialize public funtions to be used in SpotifyAPI.h
-    SpotifyAPI(const string& clientId, const string& clientSecret); 
+    SpotifyAPI(const string& clientId, const string& clientSecret, const string& accountsUrl = "");
+    ~SpotifyAPI();
     string getTrackDetails(const string& accessToken, const string& trackId);
-    string getPlaylistDetails(const string& accessToken, const string& playlistId);
-    vector<string> extractTrackIDS(string& playlistJson);
-    string extractPlaylistID(const string& url);
-    void downloadTrackImg(const string& trackDetailsJson, const string& trackID, const QString& outputPath);
+    Track getTrack(const string& accessToken, const string& trackId);
+    string getPlaylistDetails(const string& accessToken, const string& playlistId, PlaylistFields fields = PlaylistFields::Full);
+    static vector<string> extractTrackIDS(string& playlistJson);
+    void getPlaylistTrackIDsAsync(const string& accessToken, const string& playlistId, PlaylistFields fields,
+                                  function<void(PlaylistTrackIds)> callback,
+                                  function<void(size_t, const vector<TrackId>&)> onPage = nullptr);
+    static string extractPlaylistID(const string& url);
+    void getSeveralTracksAsync(const string& accessToken, const vector<TrackId>& trackIds,
+                               function<void(bool, vector<Track>)> callback);
     string getAccessToken();
-    int getVolumePercent();
-    string createPlaylist(const string& clientId, const string&playlistName);
+    string createPlaylist(const string&playlistName);
     string exchangeAuthCodeForAccessCode(const string& code, const string& redirectUri);
+    void exchangeAuthCodeAsync(const string& code, const string& redirectUri, function<void(bool)> callback);
+    string getAuthorizeUrl(const string& clientID, const string& redirectUri, const string& state = "") const;
+    bool hasUserToken() const;
+    bool ensureUserToken();
+    void setAuthorizationLostHandler(function<void()> handler);
+    bool authorizeWithPastedCode(const string& clientID);
+    void warmUp();
     string getUserID();
     string getDeviceID();
-    void resumePlayback(const string& accessToken);
-    void playTrackOnSpotify(const string& accessToken, const string& trackID);
-    void pauseTrackOnSpotify(const string& accessToken); 
-    void setVolume(const string& accessToken, int volumePercent);
     string getCurrentTrack(const string& accessToken);
+    CurrentlyPlaying getCurrentlyPlaying(const string& accessToken);
     void addTrackToPlaylist(const string& accessToken, const string& playlistID, const string& trackID);  
-    void playPlaylistOnSpotify(const string& accessToken, const string& playlistID);
+    string getConnectionStats() const;
+    string getCacheStats() const;
+    string getResponseCacheStats() const;
+    string getTokenStats() const;
+    size_t getBytesReceived() const;
+    size_t getRequestCount() const;
+
+    //asynchronous variants, the requests run concurrently on the request engine thread
+    future<HttpResponse> getTrackDetailsAsync(const string& accessToken, const string& trackId);
+    future<HttpResponse> getPlaylistDetailsAsync(const string& accessToken, const string& playlistId, PlaylistFields fields = PlaylistFields::Full);
+    future<string> getUserIDAsync();
+    future<string> getDeviceIDAsync();
+    future<HttpResponse> getCurrentTrackAsync(const string& accessToken);
+    future<HttpResponse> addTrackToPlaylistAsync(const string& accessToken, const string& playlistID, const string& trackID);
+    void setVolumeAsync(const string& accessToken, int volumePercent, const string& deviceID,
+                        function<void(HttpResponse)> callback);
+    void getDevicesAsync(const string& accessToken, function<void(bool, vector<Device>)> callback);
+    void addTracksToPlaylistAsync(const string& accessToken, const string& playlistID, const vector<string>& uris,
+                                  int position, function<void(string)> callback);
+    void sendPlaybackCommandAsync(const string& accessToken, const string& deviceID, const PlaybackCommand& command,
+                                  function<void(HttpResponse)> callback);
+
+    static constexpr size_t maxUrisPerWrite = 100; //limit of the add items to playlist endpoint
 
 private:
     string clientId; //initialize variable to contain client ID
     string clientSecret; //initialize variable to contain client secret
+    string accountsUrl; //base url of the accounts service, replaced to test against a local server
     string accessToken; //initialize variable to contain access token
-    int volumePercent; //initialize variable to contain the volume level
+    mutex clientTokenMutex; //guards accessToken, the client credentials token fetched on first use
+    string userID; //fetched once per session
+    mutex userIDMutex;
+    static constexpr size_t maxTracksPerRequest = 50; //limit of the several tracks endpoint
+    static constexpr size_t maxTracksPerPage = 100; //limit of the playlist tracks endpoint
+    static constexpr int maxRetries = 3; //times a request answered with 429 is sent again
+    CurlPool curlPool; //pooled handles shared by every request
+    RequestEngine requestEngine; //runs requests concurrently, must be declared after curlPool, stopped first by the destructor
+    TrackCache trackCache; //track metadata kept on disk between sessions
+    ResponseCache responseCache; //ETags, bodies and playlist snapshots kept on disk between sessions
+    TokenManager tokens; //user token and refresh token kept on disk between sessions, must be declared after curlPool
 
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, string* data); //initialize private functions to be used in
+    static string escape(const string& value); //initialize private functions to be used in
+    static string resolveAccountsUrl(const string& accountsUrl);
+    static bool parseDevices(const HttpResponse& response, vector<Device>& devices);
     string getSpotifyAccessToken(const string& base64); 
+    static string fieldsParameter(PlaylistFields fields, const string& prefix);
+    static HttpRequest apiRequest(const string& method, const string& url, const string& accessToken, const string& body = "");
+    void submitRetrying(const HttpRequest& request, function<void(HttpResponse)> callback, int retriesLeft = maxRetries,
+                        chrono::milliseconds delay = chrono::milliseconds::zero());
+    static string describeFailure(const HttpResponse& response);
+    void conditionalGet(const string& url, const string& accessToken, function<void(HttpResponse)> callback);
+    future<HttpResponse> conditionalGet(const string& url, const string& accessToken);
 };
 
 #endif // SPOTIFYAPI_H
\ No newline at end of file
@@ -0,0 +1,218 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the typed records that SpotifyAPI builds from Web API responses,
+ *        each response is converted once with the from_json adapters below
+*/
+#ifndef SPOTIFYTYPES_H
+#define SPOTIFYTYPES_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+using namespace std;
+
+//one size of an album cover
+struct Image {
+    string url;
+    int width = 0;
+    int height = 0;
+};
+
+struct Artist {
+    string id;
+    string name;
+};
+
+struct Album {
+    string id;
+    string name;
+    vector<Image> images; //largest first, as returned by the Web API
+};
+
+struct Track {
+    string id;
+    string name;
+    string uri;
+    int durationMs = 0;
+    vector<Artist> artists;
+    Album album;
+
+    string artistNames() const {
+        string names;
+        for (const auto& artist : artists) {
+            if (!names.empty()) names += ", ";
+            names += artist.name;
+        }
+        return names;
+    }
+
+    //url of the largest album cover, empty if the album has none
+    string imageUrl() const {
+        return album.images.empty() ? string() : album.images.front().url;
+    }
+
+    //url of the smallest album cover at least size pixels wide and high, the largest if none is
+    string imageUrl(int size) const {
+        const Image* smallest = nullptr;
+        for (const auto& image : album.images) {
+            if (image.width >= size && image.height >= size && (!smallest || image.width < smallest->width)) {
+                smallest = &image;
+            }
+        }
+        return smallest ? smallest->url : imageUrl();
+    }
+};
+
+//response of the currently playing endpoint
+struct CurrentlyPlaying {
+    bool hasTrack = false; //false when nothing is playing or the item is not a track
+    bool isPlaying = false;
+    int progressMs = 0;
+    int volumePercent = -1; //volume of the active device, -1 if unknown
+    string deviceID; //device the playback is on, empty if unknown
+    Track track;
+};
+
+//one device of the user as listed by the devices endpoint
+struct Device {
+    string id; //empty for devices that cannot be targeted
+    string name;
+    string type;
+    bool isActive = false;
+    bool isRestricted = false; //the device accepts no Web API commands
+    bool supportsVolume = false;
+    int volumePercent = -1; //-1 if unknown
+
+    //true if commands can be sent to the device
+    bool canTarget() const { return !id.empty() && !isRestricted; }
+};
+
+//one command of the player endpoints, see PlaybackCommandQueue
+struct PlaybackCommand {
+    enum Kind { Resume, Pause, PlayTrack, PlayContext };
+    Kind kind = Resume;
+    string uri; //track or context to start, empty for Resume and Pause
+
+    static PlaybackCommand resume() { return {Resume, ""}; }
+    static PlaybackCommand pause() { return {Pause, ""}; }
+    static PlaybackCommand playTrack(const string& trackID) { return {PlayTrack, "spotify:track:" + trackID}; }
+    static PlaybackCommand playContext(const string& contextUri) { return {PlayContext, contextUri}; }
+
+    //true if playback is running once the command has been applied
+    bool playing() const { return kind != Pause; }
+    //true if the command only resumes or pauses whatever is loaded
+    bool toggles() const { return kind == Resume || kind == Pause; }
+    const char* name() const {
+        static const char* names[] = {"resume", "pause", "play track", "play context"};
+        return names[kind];
+    }
+};
+
+/** @brief reads a string field, treating a missing or null field as empty
+ */
+inline string stringField(const nlohmann::json& j, const char* key) {
+    auto it = j.find(key);
+    return (it != j.end() && it->is_string()) ? it->get<string>() : string();
+}
+
+/** @brief reads an integer field, treating a missing or null field as 0
+ */
+inline int intField(const nlohmann::json& j, const char* key) {
+    auto it = j.find(key);
+    return (it != j.end() && it->is_number()) ? it->get<int>() : 0;
+}
+
+/** @brief reads a boolean field, treating a missing or null field as false
+ */
+inline bool boolField(const nlohmann::json& j, const char* key) {
+    auto it = j.find(key);
+    return it != j.end() && it->is_boolean() && it->get<bool>();
+}
+
+/** @brief from_json adapters, used by json::get<T>()
+ */
+inline void from_json(const nlohmann::json& j, Image& image) {
+    image.url = stringField(j, "url");
+    image.width = intField(j, "width");
+    image.height = intField(j, "height");
+}
+
+inline void from_json(const nlohmann::json& j, Artist& artist) {
+    artist.id = stringField(j, "id");
+    artist.name = stringField(j, "name");
+}
+
+inline void from_json(const nlohmann::json& j, Album& album) {
+    album.id = stringField(j, "id");
+    album.name = stringField(j, "name");
+    album.images.clear();
+    auto images = j.find("images");
+    if (images != j.end() && images->is_array()) {
+        album.images = images->get<vector<Image>>();
+    }
+}
+
+inline void from_json(const nlohmann::json& j, Track& track) {
+    track.id = stringField(j, "id");
+    track.name = stringField(j, "name");
+    track.uri = stringField(j, "uri");
+    track.durationMs = intField(j, "duration_ms");
+    track.artists.clear();
+    auto artists = j.find("artists");
+    if (artists != j.end() && artists->is_array()) {
+        track.artists = artists->get<vector<Artist>>();
+    }
+    auto album = j.find("album");
+    track.album = (album != j.end() && album->is_object()) ? album->get<Album>() : Album();
+}
+
+inline void from_json(const nlohmann::json& j, CurrentlyPlaying& playing) {
+    auto isPlaying = j.find("is_playing");
+    playing.isPlaying = isPlaying != j.end() && isPlaying->is_boolean() && isPlaying->get<bool>();
+    playing.progressMs = intField(j, "progress_ms");
+    playing.volumePercent = -1;
+    playing.deviceID.clear();
+    auto device = j.find("device");
+    if (device != j.end() && device->is_object()) {
+        auto volume = device->find("volume_percent");
+        if (volume != device->end() && volume->is_number()) playing.volumePercent = volume->get<int>();
+        playing.deviceID = stringField(*device, "id");
+    }
+    auto item = j.find("item");
+    playing.hasTrack = item != j.end() && item->is_object() && stringField(*item, "type") == "track";
+    playing.track = playing.hasTrack ? item->get<Track>() : Track();
+}
+
+inline void from_json(const nlohmann::json& j, Device& device) {
+    device.id = stringField(j, "id");
+    device.name = stringField(j, "name");
+    device.type = stringField(j, "type");
+    device.isActive = boolField(j, "is_active");
+    device.isRestricted = boolField(j, "is_restricted");
+    device.supportsVolume = boolField(j, "supports_volume");
+    auto volume = j.find("volume_percent");
+    device.volumePercent = (volume != j.end() && volume->is_number()) ? volume->get<int>() : -1;
+}
+
+/** @brief to_json adapters, used to store records in the local caches
+ */
+inline void to_json(nlohmann::json& j, const Image& image) {
+    j = {{"url", image.url}, {"width", image.width}, {"height", image.height}};
+}
+
+inline void to_json(nlohmann::json& j, const Artist& artist) {
+    j = {{"id", artist.id}, {"name", artist.name}};
+}
+
+inline void to_json(nlohmann::json& j, const Album& album) {
+    j = {{"id", album.id}, {"name", album.name}, {"images", album.images}};
+}
+
+inline void to_json(nlohmann::json& j, const Track& track) {
+    j = {{"id", track.id}, {"name", track.name}, {"uri", track.uri}, {"duration_ms", track.durationMs},
+         {"artists", track.artists}, {"album", track.album}};
+}
+
+#endif // SPOTIFYTYPES_H
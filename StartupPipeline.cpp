@@ -0,0 +1,262 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class runs the independent startup steps concurrently instead of one after another.
+ *        Steps name the steps they need, run on a small thread pool or the GUI thread, and a step
+ *        whose dependency failed is skipped. The time of every step is kept for the startup report
+*/
+
+#include "StartupPipeline.h"
+#include <QRunnable>
+#include <QMetaObject>
+#include <algorithm>
+#include <climits>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <exception>
+
+namespace {
+//runs a function on a thread pool
+class Job : public QRunnable {
+public:
+    explicit Job(function<void()> work) : work(move(work)) {}
+    void run() override { work(); }
+private:
+    function<void()> work;
+};
+
+//runs a step, an exception fails the step instead of escaping into the thread pool or the event loop
+bool runStep(const string& name, const function<bool()>& work) {
+    try {
+        return work();
+    }
+    catch (const exception& error) {
+        cerr << "Startup step " << name << " threw: " << error.what() << endl;
+    }
+    catch (...) {
+        cerr << "Startup step " << name << " threw" << endl;
+    }
+    return false;
+}
+}
+
+/** @brief Constructor for the StartupPipeline class, starts the clock
+ * @param maxWorkers number of worker steps that may run at the same time
+ * @param parent owner of the pipeline, it must live on the GUI thread
+ */
+StartupPipeline::StartupPipeline(int maxWorkers, QObject* parent) : QObject(parent), remaining(0) {
+    workers.setMaxThreadCount(maxWorkers);
+    clock.start();
+}
+
+/** @brief Destructor, waits for the worker steps since they use objects owned by the caller
+ */
+StartupPipeline::~StartupPipeline() {
+    workers.clear();
+    workers.waitForDone();
+}
+
+/** @brief adds a step that is done when its function returns
+ * @param name name of the step, used by the steps that need it and in the report
+ * @param after names of the steps that must have succeeded first
+ * @param work the step, returns false if it failed
+ * @param thread where the step runs
+ */
+void StartupPipeline::addStep(const string& name, const vector<string>& after, function<bool()> work, Thread thread) {
+    addPendingStep(name, after, [this, name, work, thread](function<void(bool)> done) {
+        if (thread == Gui) {
+            done(runStep(name, work));
+            return;
+        }
+        workers.start(new Job([name, work, done]() { done(runStep(name, work)); }));
+    });
+}
+
+/** @brief adds a step that is done when it calls back, such as one waiting for the user
+ * @param name name of the step, used by the steps that need it and in the report
+ * @param after names of the steps that must have succeeded first
+ * @param start starts the step on the GUI thread, the callback may be called from any thread
+ */
+void StartupPipeline::addPendingStep(const string& name, const vector<string>& after, function<void(function<void(bool)>)> start) {
+    stepIndex[name] = steps.size();
+    Step step;
+    step.name = name;
+    step.after = after;
+    step.start = move(start);
+    steps.push_back(move(step));
+}
+
+/** @brief runs a failed step again, the steps skipped because of it wait for it again
+ * @param name name of the step
+ * @return false if the step is unknown or has not failed
+ */
+bool StartupPipeline::retry(const string& name) {
+    auto it = stepIndex.find(name);
+    if (it == stepIndex.end() || steps[it->second].state != Failed) {
+        return false;
+    }
+    reset(it->second);
+    launch(it->second);
+    return true;
+}
+
+/** @brief records the time of an event that is not a step, such as the window being shown
+ * @param event name of the event
+ */
+void StartupPipeline::mark(const string& event) {
+    marks.push_back({event, clock.elapsed()});
+}
+
+/** @brief checks whether a step has succeeded
+ * @param name name of the step
+ * @return true if it is done
+ */
+bool StartupPipeline::isDone(const string& name) const {
+    auto it = stepIndex.find(name);
+    return it != stepIndex.end() && steps[it->second].state == Done;
+}
+
+/** @brief resolves the dependencies and launches every step that needs none
+ */
+void StartupPipeline::start() {
+    mark("event loop running");
+    remaining = steps.size();
+    for (size_t i = 0; i < steps.size(); i++) {
+        for (const string& name : steps[i].after) {
+            auto it = stepIndex.find(name);
+            if (it == stepIndex.end()) {
+                cerr << "Startup step " << steps[i].name << " needs unknown step " << name << endl;
+                continue;
+            }
+            steps[it->second].dependents.push_back(i);
+            steps[i].unfinished++;
+        }
+    }
+    //completions are always queued, so a step finishing right away cannot launch anything during this loop
+    for (size_t i = 0; i < steps.size(); i++) {
+        if (steps[i].unfinished == 0) {
+            launch(i);
+        }
+    }
+    if (steps.empty()) {
+        emit finished();
+    }
+}
+
+/** @brief runs one step, its completion is handled on the GUI thread
+ * @param index the step
+ */
+void StartupPipeline::launch(size_t index) {
+    Step& step = steps[index];
+    step.state = Running;
+    step.startedMs = clock.elapsed();
+    step.start([this, index](bool ok) {
+        QMetaObject::invokeMethod(this, [this, index, ok]() { completed(index, ok); }, Qt::QueuedConnection);
+    });
+}
+
+/** @brief records a completed step and launches the steps that were only waiting for it
+ * @param index the step
+ * @param ok false if the step failed, the steps that need it are skipped
+ */
+void StartupPipeline::completed(size_t index, bool ok) {
+    Step& step = steps[index];
+    step.finishedMs = clock.elapsed();
+    step.state = ok ? Done : Failed;
+    remaining--;
+    if (!ok) {
+        cerr << "Startup step " << step.name << " failed" << endl;
+    }
+    for (size_t dependent : step.dependents) {
+        if (!ok) {
+            skip(dependent);
+        }
+        else if (--steps[dependent].unfinished == 0 && steps[dependent].state == Waiting) {
+            launch(dependent);
+        }
+    }
+    if (remaining == 0) {
+        emit finished();
+    }
+}
+
+/** @brief skips a step whose dependency failed, along with every step that needs it
+ * @param index the step
+ */
+void StartupPipeline::skip(size_t index) {
+    if (steps[index].state != Waiting) {
+        return;
+    }
+    steps[index].state = Skipped;
+    remaining--;
+    for (size_t dependent : steps[index].dependents) {
+        skip(dependent);
+    }
+}
+
+/** @brief puts a failed or skipped step back to waiting, along with the skipped steps that need it
+ *  and nothing else that failed
+ * @param index the step
+ */
+void StartupPipeline::reset(size_t index) {
+    steps[index].state = Waiting;
+    steps[index].startedMs = -1;
+    steps[index].finishedMs = -1;
+    remaining++;
+    for (size_t dependent : steps[index].dependents) {
+        if (steps[dependent].state != Skipped) {
+            continue;
+        }
+        //a step that also needs another failed step stays skipped, it could never run
+        bool blocked = false;
+        for (const string& name : steps[dependent].after) {
+            auto it = stepIndex.find(name);
+            State needed = it == stepIndex.end() ? Done : steps[it->second].state;
+            blocked = blocked || needed == Failed || needed == Skipped;
+        }
+        if (!blocked) {
+            reset(dependent);
+        }
+    }
+}
+
+/** @brief builds the startup timing breakdown, one line per step in the order they started
+ * @return the report
+ */
+string StartupPipeline::getReport() const {
+    ostringstream report;
+    qint64 readyMs = 0;
+    for (const Step& step : steps) {
+        readyMs = max(readyMs, step.finishedMs);
+    }
+    report << "Startup: ready after " << readyMs << " ms";
+    for (const auto& event : marks) {
+        report << ", " << event.first << " at " << event.second << " ms";
+    }
+
+    vector<const Step*> ordered;
+    for (const Step& step : steps) {
+        ordered.push_back(&step);
+    }
+    stable_sort(ordered.begin(), ordered.end(), [](const Step* a, const Step* b) {
+        //steps that never started go last
+        return (a->startedMs < 0 ? LLONG_MAX : a->startedMs) < (b->startedMs < 0 ? LLONG_MAX : b->startedMs);
+    });
+    for (const Step* step : ordered) {
+        report << "\n  " << left << setw(18) << step->name << right;
+        switch (step->state) {
+        case Done:
+        case Failed:
+            report << setw(6) << step->startedMs << " -> " << setw(6) << step->finishedMs << " ms ("
+                   << step->finishedMs - step->startedMs << " ms" << (step->state == Failed ? ", failed)" : ")");
+            break;
+        case Skipped:
+            report << "skipped, a step it needs failed";
+            break;
+        default:
+            report << "not finished";
+        }
+    }
+    return report.str();
+}
@@ -0,0 +1,72 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables, methods and signals of the StartupPipeline class
+*/
+#ifndef STARTUPPIPELINE_H
+#define STARTUPPIPELINE_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <QObject>
+#include <QThreadPool>
+#include <QElapsedTimer>
+
+using namespace std;
+
+//runs the startup steps as a dependency graph, each step starts as soon as the steps it needs are done
+class StartupPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    //where a step runs, GUI steps must be short since they hold up the event loop
+    enum Thread { Worker, Gui };
+
+    //initialize public functions to be used in StartupPipeline.cpp
+    explicit StartupPipeline(int maxWorkers = 4, QObject* parent = nullptr);
+    ~StartupPipeline();
+
+    void addStep(const string& name, const vector<string>& after, function<bool()> work, Thread thread = Worker);
+    void addPendingStep(const string& name, const vector<string>& after, function<void(function<void(bool)>)> start);
+    bool retry(const string& name);
+    void mark(const string& event);
+    bool isDone(const string& name) const;
+    string getReport() const;
+
+public slots:
+    void start();
+
+signals:
+    //every step has completed or was skipped
+    void finished();
+
+private:
+    enum State { Waiting, Running, Done, Failed, Skipped };
+
+    struct Step {
+        string name;
+        vector<string> after;
+        function<void(function<void(bool)>)> start; //runs the step, calls back with its result from any thread
+        State state = Waiting;
+        size_t unfinished = 0; //steps it needs that are not done yet
+        vector<size_t> dependents;
+        qint64 startedMs = -1;
+        qint64 finishedMs = -1;
+    };
+
+    vector<Step> steps;
+    map<string, size_t> stepIndex;
+    QThreadPool workers;
+    QElapsedTimer clock; //started with the pipeline object, so it includes building the window
+    vector<pair<string, qint64>> marks;
+    size_t remaining;
+
+    void launch(size_t index);
+    void completed(size_t index, bool ok);
+    void skip(size_t index);
+    void reset(size_t index);
+};
+
+#endif // STARTUPPIPELINE_H
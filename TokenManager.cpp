@@ -0,0 +1,260 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class keeps the user access token and its refresh token on disk so a restart reuses
+ *        them instead of authorizing again, and refreshes the access token on its own thread
+ *        shortly before it expires
+*/
+
+#include "TokenManager.h"
+#include "json.hpp"
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <iostream>
+#include <sstream>
+
+using json = nlohmann::json;
+
+/** @brief Constructor for the TokenManager class, loads the stored tokens and starts the refresher
+ * @param pool used to send the refresh requests
+ * @param path file holding the tokens between sessions
+ * @param clientCredentials base64 of client id:client secret
+ * @param accountsUrl base url of the accounts service
+ * @param refreshMarginSeconds how long before expiry a token is refreshed
+ */
+TokenManager::TokenManager(CurlPool& pool, const QString& path, const string& clientCredentials, const string& accountsUrl,
+                           int refreshMarginSeconds)
+    : pool(pool), path(path), clientCredentials(clientCredentials), accountsUrl(accountsUrl), refreshMarginSeconds(refreshMarginSeconds),
+      current(nullptr), stopping(false), refreshes(0), failures(0), loadedFromDisk(false) {
+    load();
+    refresher = thread(&TokenManager::run, this);
+}
+
+/** @brief Destructor, stops the refresher thread
+ */
+TokenManager::~TokenManager() {
+    {
+        lock_guard<mutex> lock(refresherMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    refresher.join();
+}
+
+/** @brief getter method for the current access token, safe to call from any thread without locking
+ * @return the access token, empty if there is none
+ */
+string TokenManager::getAccessToken() const {
+    const AccessToken* token = current.load(memory_order_acquire);
+    return token ? token->accessToken : string();
+}
+
+/** @brief checks whether the current access token can be used right away
+ * @return true if it does not expire within the next minute
+ */
+bool TokenManager::hasValidToken() const {
+    const AccessToken* token = current.load(memory_order_acquire);
+    return token && token->validFor(60);
+}
+
+/** @brief checks whether a new access token can be had without authorizing again
+ * @return true if a refresh token is known
+ */
+bool TokenManager::canRefresh() const {
+    const AccessToken* token = current.load(memory_order_acquire);
+    return token && !token->refreshToken.empty();
+}
+
+/** @brief publishes the token in a response of the accounts service, and stores it
+ *  A refresh response may leave out the refresh token, the previous one stays valid then.
+ * @param tokenResponse JSON body of the token endpoint
+ * @return false if the response holds no access token
+ */
+bool TokenManager::publish(const string& tokenResponse) {
+    auto parsed = json::parse(tokenResponse, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object() || !parsed.contains("access_token")) {
+        return false;
+    }
+    auto token = make_unique<AccessToken>();
+    token->accessToken = parsed.value("access_token", "");
+    token->refreshToken = parsed.value("refresh_token", "");
+    if (token->refreshToken.empty()) {
+        const AccessToken* previous = current.load(memory_order_acquire);
+        token->refreshToken = previous ? previous->refreshToken : string();
+    }
+    token->expiresAt = chrono::system_clock::now() + chrono::seconds(parsed.value("expires_in", 3600));
+    install(move(token), true);
+    return true;
+}
+
+/** @brief makes a token current and wakes the refresher so it is timed from the new expiry
+ * @param token the token
+ * @param persist true to write the token to disk as well
+ */
+void TokenManager::install(unique_ptr<const AccessToken> token, bool persist) {
+    {
+        lock_guard<mutex> lock(publishMutex);
+        if (persist) {
+            save(*token);
+        }
+        current.store(token.get(), memory_order_release);
+        issued.push_back(move(token));
+    }
+    wake.notify_all();
+}
+
+/** @brief exchanges the refresh token for a new access token, blocks until the response arrives
+ * @return true if a new token was published
+ */
+bool TokenManager::refresh() {
+    const AccessToken* token = current.load(memory_order_acquire);
+    if (!token || token->refreshToken.empty()) {
+        return false;
+    }
+    HttpRequest request;
+    request.method = "POST";
+    request.url = accountsUrl + "/api/token";
+    request.headers = {"Authorization: Basic " + clientCredentials, "Content-Type: application/x-www-form-urlencoded"};
+    char* escaped = curl_easy_escape(nullptr, token->refreshToken.c_str(), static_cast<int>(token->refreshToken.length()));
+    request.body = "grant_type=refresh_token&refresh_token=" + string(escaped ? escaped : "");
+    curl_free(escaped);
+
+    HttpResponse response = pool.perform(request);
+    if (response.ok() && response.status == 200 && publish(response.body)) {
+        refreshes++;
+        return true;
+    }
+    failures++;
+    //the refresh token was revoked or has expired, retrying cannot succeed, the user has to authorize again
+    if (response.ok() && response.status == 400) {
+        auto error = json::parse(response.body, nullptr, false);
+        if (error.is_object() && error.value("error", "") == "invalid_grant") {
+            revoke(token);
+            return false;
+        }
+    }
+    cerr << "Could not refresh the access token: " << (response.ok() ? "HTTP " + to_string(response.status)
+                                                                     : string(curl_easy_strerror(response.result))) << endl;
+    return false;
+}
+
+/** @brief drops a token whose refresh token was rejected, the refresher then sleeps until a new one is published
+ * @param token the rejected token, nothing is dropped if another one was published meanwhile
+ */
+void TokenManager::revoke(const AccessToken* token) {
+    function<void()> handler;
+    {
+        lock_guard<mutex> lock(publishMutex);
+        if (current.load(memory_order_acquire) != token) {
+            return;
+        }
+        current.store(nullptr, memory_order_release);
+        QFile::remove(path);
+        handler = revokedHandler;
+    }
+    cerr << "The refresh token was rejected, the user has to authorize again" << endl;
+    if (handler) {
+        handler();
+    }
+}
+
+/** @brief sets what to do once the refresh token has been rejected, such as opening the authorize page
+ * @param handler called on the thread that tried to refresh, it must not block
+ */
+void TokenManager::setRevokedHandler(function<void()> handler) {
+    lock_guard<mutex> lock(publishMutex);
+    revokedHandler = move(handler);
+}
+
+/** @brief event loop of the refresher thread, sleeps until the current token is due for a refresh
+ */
+void TokenManager::run() {
+    unique_lock<mutex> lock(refresherMutex);
+    while (!stopping) {
+        const AccessToken* token = current.load(memory_order_acquire);
+        if (!token || token->refreshToken.empty()) {
+            //nothing to refresh until a token is published
+            wake.wait(lock);
+            continue;
+        }
+        auto due = token->expiresAt - chrono::seconds(refreshMarginSeconds);
+        if (chrono::system_clock::now() < due) {
+            wake.wait_until(lock, due);
+            continue;
+        }
+        lock.unlock();
+        bool refreshed = refresh();
+        lock.lock();
+        if (!refreshed && !stopping) {
+            //try again later, the token may still be usable until then
+            wake.wait_for(lock, chrono::seconds(30));
+        }
+    }
+}
+
+/** @brief reads the stored tokens, an expired access token is kept for its refresh token
+ */
+void TokenManager::load() {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QByteArray data = file.readAll();
+    auto stored = json::parse(data.constData(), data.constData() + data.size(), nullptr, false);
+    if (stored.is_discarded() || !stored.is_object()) {
+        return;
+    }
+    auto token = make_unique<AccessToken>();
+    token->accessToken = stored.value("access_token", "");
+    token->refreshToken = stored.value("refresh_token", "");
+    token->expiresAt = chrono::system_clock::time_point(chrono::seconds(stored.value("expires_at", static_cast<long long>(0))));
+    if (token->accessToken.empty() && token->refreshToken.empty()) {
+        return;
+    }
+    loadedFromDisk = true;
+    install(move(token), false);
+}
+
+/** @brief writes a token to disk, readable by the current user only
+ * @param token the token
+ */
+void TokenManager::save(const AccessToken& token) {
+    long long expiresAt = chrono::duration_cast<chrono::seconds>(token.expiresAt.time_since_epoch()).count();
+    json stored = {{"access_token", token.accessToken}, {"refresh_token", token.refreshToken}, {"expires_at", expiresAt}};
+    string data = stored.dump();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    //written to a temporary file that replaces the store on commit, so a crash never leaves half a token,
+    //and the temporary file is restricted before the token is written into it
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        cerr << "Could not write token store: " << path.toStdString() << endl;
+        return;
+    }
+    if (!file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner)) {
+        cerr << "Could not restrict token store: " << path.toStdString() << endl;
+        file.cancelWriting();
+        return;
+    }
+    file.write(data.c_str(), static_cast<qint64>(data.size()));
+    if (!file.commit()) {
+        cerr << "Could not write token store: " << path.toStdString() << endl;
+    }
+}
+
+/** @brief builds a one line summary of where the token came from and how often it was refreshed
+ * @return the summary
+ */
+string TokenManager::getStatsReport() const {
+    ostringstream report;
+    report << "Tokens: " << (loadedFromDisk ? "loaded from disk" : "not stored") << ", " << refreshes
+           << " refreshes, " << failures << " failed";
+    const AccessToken* token = current.load(memory_order_acquire);
+    if (token) {
+        auto left = chrono::duration_cast<chrono::minutes>(token->expiresAt - chrono::system_clock::now()).count();
+        report << ", current token " << (left > 0 ? "expires in " + to_string(left) + " min" : string("expired"));
+    }
+    return report.str();
+}
@@ -0,0 +1,82 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the TokenManager class
+*/
+#ifndef TOKENMANAGER_H
+#define TOKENMANAGER_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <QString>
+#include "CurlPool.h"
+
+using namespace std;
+
+//one user access token as returned by the accounts service, never changed once published
+struct AccessToken {
+    string accessToken;
+    string refreshToken;
+    chrono::system_clock::time_point expiresAt;
+
+    //true if the token can still be used for at least marginSeconds
+    bool validFor(int marginSeconds) const {
+        return !accessToken.empty() && chrono::system_clock::now() + chrono::seconds(marginSeconds) < expiresAt;
+    }
+};
+
+class TokenManager {
+public:
+    //initialize public functions to be used in TokenManager.cpp
+    TokenManager(CurlPool& pool, const QString& path, const string& clientCredentials,
+                 const string& accountsUrl = "https://accounts.spotify.com", int refreshMarginSeconds = 300);
+    ~TokenManager();
+    TokenManager(const TokenManager&) = delete;
+    TokenManager& operator=(const TokenManager&) = delete;
+
+    string getAccessToken() const;
+    bool hasValidToken() const;
+    bool canRefresh() const;
+    bool publish(const string& tokenResponse);
+    bool refresh();
+    void setRevokedHandler(function<void()> handler);
+    string getStatsReport() const;
+
+private:
+    CurlPool& pool;
+    QString path; //file holding the tokens between sessions
+    string clientCredentials; //base64 of client id:client secret, used to refresh
+    string accountsUrl; //base url of the accounts service
+    int refreshMarginSeconds; //a token is refreshed this long before it expires
+
+    //readers only load this pointer, every token ever published is kept in issued until destruction
+    //so a reader never sees one freed under it
+    atomic<const AccessToken*> current;
+    vector<unique_ptr<const AccessToken>> issued;
+    mutex publishMutex; //serializes writers, readers never take it
+    function<void()> revokedHandler; //called once the refresh token has been rejected, guarded by publishMutex
+
+    thread refresher;
+    mutex refresherMutex;
+    condition_variable wake;
+    bool stopping;
+
+    atomic<size_t> refreshes;
+    atomic<size_t> failures;
+    bool loadedFromDisk;
+
+    void load();
+    void save(const AccessToken& token);
+    void install(unique_ptr<const AccessToken> token, bool persist);
+    void revoke(const AccessToken* token);
+    void run();
+};
+
+#endif // TOKENMANAGER_H
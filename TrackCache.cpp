@@ -0,0 +1,198 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class keeps track metadata in a memory mapped file keyed by track ID, so tracks seen
+ *        in an earlier session are served locally instead of being requested again
+*/
+
+#include "TrackCache.h"
+#include <QDir>
+#include <QFileInfo>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+namespace {
+const char cacheMagic[8] = {'S', 'P', 'T', 'R', 'A', 'C', 'K', 'S'};
+const uint32_t cacheVersion = 1;
+}
+
+/** @brief Constructor for the TrackCache class, maps the cache file and creates it if needed
+ * @param path location of the cache file
+ * @param ttlSeconds age after which an entry is treated as a miss
+ * @param slotCount number of entries the file holds, rounded up to a whole number of sets
+ */
+TrackCache::TrackCache(const QString& path, int64_t ttlSeconds, uint32_t slotCount)
+    : file(path), header(nullptr), entries(nullptr), ttlSeconds(ttlSeconds),
+      slotCount((slotCount + ways - 1) / ways * ways), hits(0), misses(0), evictions(0) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    qint64 size = sizeof(Header) + static_cast<qint64>(this->slotCount) * sizeof(Slot);
+
+    if (!file.open(QIODevice::ReadWrite) || !file.resize(size)) {
+        cerr << "Could not open track cache: " << path.toStdString() << endl;
+        return;
+    }
+    uchar* mapping = file.map(0, size);
+    if (!mapping) {
+        cerr << "Could not map track cache: " << path.toStdString() << endl;
+        return;
+    }
+
+    header = reinterpret_cast<Header*>(mapping);
+    entries = reinterpret_cast<Slot*>(mapping + sizeof(Header));
+    //a new file, or one written with a different layout, starts out empty
+    if (memcmp(header->magic, cacheMagic, sizeof(cacheMagic)) != 0 || header->version != cacheVersion ||
+        header->slotCount != this->slotCount) {
+        memset(mapping, 0, static_cast<size_t>(size));
+        memcpy(header->magic, cacheMagic, sizeof(cacheMagic));
+        header->version = cacheVersion;
+        header->slotCount = this->slotCount;
+    }
+}
+
+/** @brief Destructor, the mapping is written back to the file when it is unmapped
+ */
+TrackCache::~TrackCache() {
+    if (header) {
+        file.unmap(reinterpret_cast<uchar*>(header));
+    }
+    file.close();
+}
+
+/** @brief reads every page of the mapping once, so later lookups do not wait for the file to be paged in
+ */
+void TrackCache::prefetch() {
+    lock_guard<mutex> lock(cacheMutex);
+    if (!header) {
+        return;
+    }
+    volatile uint64_t touched = 0;
+    for (uint32_t i = 0; i < slotCount; i++) {
+        touched = touched + entries[i].high;
+    }
+}
+
+/** @brief finds the set of entries a track ID can be stored in
+ * @param id the track ID
+ * @return pointer to the first of the ways entries of the set
+ */
+TrackCache::Slot* TrackCache::setFor(const TrackId& id) const {
+    uint32_t setCount = slotCount / ways;
+    return entries + (id.hash() % setCount) * ways;
+}
+
+/** @brief looks up a track
+ * @param id the track ID
+ * @param track receives the cached track on a hit
+ * @return true on a hit, false if the track is missing or older than the TTL
+ */
+bool TrackCache::lookup(const TrackId& id, Track& track) {
+    lock_guard<mutex> lock(cacheMutex);
+    if (!header) {
+        misses++;
+        return false;
+    }
+
+    Slot* set = setFor(id);
+    for (uint32_t way = 0; way < ways; way++) {
+        Slot& slot = set[way];
+        if (slot.high != id.getHigh() || slot.low != id.getLow()) {
+            continue;
+        }
+        if (static_cast<int64_t>(time(nullptr)) - slot.storedAt > ttlSeconds) {
+            break;
+        }
+        //the file may have been truncated or written by another build, a length past the slot is a miss
+        if (slot.length > sizeof(slot.data)) {
+            break;
+        }
+        auto cached = nlohmann::json::parse(slot.data, slot.data + slot.length, nullptr, false);
+        if (cached.is_discarded()) {
+            break;
+        }
+        track = cached.get<Track>();
+        slot.lastUsed = ++header->clock;
+        hits++;
+        return true;
+    }
+    misses++;
+    return false;
+}
+
+/** @brief stores a track, replacing the least recently used entry of its set if the set is full
+ * @param id the track ID
+ * @param track the track to store, tracks too large for a slot are not cached
+ */
+void TrackCache::store(const TrackId& id, const Track& track) {
+    string data = nlohmann::json(track).dump();
+    if (!id.isValid() || data.length() > sizeof(Slot::data)) {
+        return;
+    }
+
+    lock_guard<mutex> lock(cacheMutex);
+    if (!header) {
+        return;
+    }
+
+    Slot* set = setFor(id);
+    Slot* target = nullptr;
+    for (uint32_t way = 0; way < ways && !target; way++) {
+        if (set[way].high == id.getHigh() && set[way].low == id.getLow()) {
+            target = &set[way];
+        }
+    }
+    for (uint32_t way = 0; way < ways && !target; way++) {
+        if (set[way].high == 0 && set[way].low == 0) {
+            target = &set[way];
+        }
+    }
+    if (!target) {
+        target = &set[0];
+        for (uint32_t way = 1; way < ways; way++) {
+            if (set[way].lastUsed < target->lastUsed) {
+                target = &set[way];
+            }
+        }
+        evictions++;
+    }
+
+    target->high = id.getHigh();
+    target->low = id.getLow();
+    target->storedAt = static_cast<int64_t>(time(nullptr));
+    target->lastUsed = ++header->clock;
+    target->length = static_cast<uint32_t>(data.length());
+    memcpy(target->data, data.data(), data.length());
+}
+
+/** @brief getter method for the number of lookups served from the cache
+ * @return hits
+ */
+size_t TrackCache::getHits() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return hits;
+}
+
+/** @brief getter method for the number of lookups that had to go to the network
+ * @return misses
+ */
+size_t TrackCache::getMisses() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return misses;
+}
+
+/** @brief getter method for the number of entries replaced to make room
+ * @return evictions
+ */
+size_t TrackCache::getEvictions() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return evictions;
+}
+
+/** @brief builds a one line summary of the cache counters
+ * @return the summary
+ */
+string TrackCache::getStatsReport() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return "Track cache: " + to_string(hits) + " hits, " + to_string(misses) + " misses, " +
+           to_string(evictions) + " evictions";
+}
@@ -0,0 +1,71 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables and methods of the TrackCache class
+*/
+#ifndef TRACKCACHE_H
+#define TRACKCACHE_H
+//include necessary libraries
+#include <string>
+#include <cstdint>
+#include <mutex>
+#include <QFile>
+#include <QString>
+#include "SpotifyTypes.h"
+#include "TrackId.h"
+
+using namespace std;
+
+class TrackCache {
+public:
+    //initialize public functions to be used in TrackCache.cpp
+    TrackCache(const QString& path, int64_t ttlSeconds = 7 * 24 * 60 * 60, uint32_t slotCount = 8192);
+    ~TrackCache();
+    TrackCache(const TrackCache&) = delete;
+    TrackCache& operator=(const TrackCache&) = delete;
+
+    bool lookup(const TrackId& id, Track& track);
+    void store(const TrackId& id, const Track& track);
+    void prefetch();
+
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getEvictions() const;
+    string getStatsReport() const;
+
+private:
+    static constexpr uint32_t ways = 8; //entries per set, eviction picks the least recently used of the set
+    static constexpr uint32_t slotSize = 1024;
+
+    //layout of the mapped file: one header followed by slotCount entries
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t slotCount;
+        uint64_t clock; //increases on every access, gives the recency of each slot
+    };
+    struct Slot {
+        uint64_t high; //key, both halves are zero for an empty slot
+        uint64_t low;
+        int64_t storedAt; //unix time when the entry was written, for the TTL
+        uint64_t lastUsed; //value of the clock at the last access, for LRU eviction
+        uint32_t length;
+        uint32_t reserved;
+        char data[slotSize - 40]; //the track as compact JSON
+    };
+
+    QFile file;
+    Header* header; //points into the mapping, nullptr if the cache could not be opened
+    Slot* entries;
+    int64_t ttlSeconds;
+    uint32_t slotCount;
+    mutable mutex cacheMutex;
+
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+
+    Slot* setFor(const TrackId& id) const;
+};
+
+#endif // TRACKCACHE_H
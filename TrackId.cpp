@@ -0,0 +1,83 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class converts Spotify IDs between their 22 character base62 form and 128 bits
+*/
+
+#include "TrackId.h"
+
+namespace {
+const char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/** @brief value of one base62 digit
+ * @return the value, or -1 if the character is not a base62 digit
+ */
+int digitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 36;
+    return -1;
+}
+}
+
+/** @brief decodes a base62 Spotify ID
+ * @param base62 the 22 character ID, for example 4iV5W9uYEdYUVa79Axb7Rh
+ * @param ok optional, set to false if the string is not a valid ID
+ * @return the decoded ID, or an invalid (zero) ID on failure
+ */
+TrackId TrackId::fromBase62(const string& base62, bool* ok) {
+    if (ok) *ok = false;
+    if (base62.length() != base62Length) {
+        return TrackId();
+    }
+
+    //the number is held in four 32 bit limbs, most significant first, so each step fits in 64 bits
+    uint32_t limbs[4] = {0, 0, 0, 0};
+    for (char c : base62) {
+        int digit = digitValue(c);
+        if (digit < 0) {
+            return TrackId();
+        }
+        uint64_t carry = static_cast<uint64_t>(digit);
+        for (int i = 3; i >= 0; i--) {
+            uint64_t value = static_cast<uint64_t>(limbs[i]) * 62 + carry;
+            limbs[i] = static_cast<uint32_t>(value);
+            carry = value >> 32;
+        }
+        if (carry != 0) {
+            return TrackId(); //larger than 128 bits
+        }
+    }
+
+    TrackId id;
+    id.high = (static_cast<uint64_t>(limbs[0]) << 32) | limbs[1];
+    id.low = (static_cast<uint64_t>(limbs[2]) << 32) | limbs[3];
+    if (ok) *ok = true;
+    return id;
+}
+
+/** @brief encodes the ID back to its base62 form
+ * @return the 22 character ID
+ */
+string TrackId::toBase62() const {
+    uint32_t limbs[4] = {static_cast<uint32_t>(high >> 32), static_cast<uint32_t>(high),
+                         static_cast<uint32_t>(low >> 32), static_cast<uint32_t>(low)};
+    string base62(base62Length, '0');
+    for (size_t position = base62Length; position-- > 0;) {
+        uint64_t remainder = 0;
+        for (int i = 0; i < 4; i++) {
+            uint64_t value = (remainder << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(value / 62);
+            remainder = value % 62;
+        }
+        base62[position] = alphabet[remainder];
+    }
+    return base62;
+}
+
+/** @brief formats the ID as a track uri
+ * @return spotify:track:(id)
+ */
+string TrackId::toUri() const {
+    return "spotify:track:" + toBase62();
+}
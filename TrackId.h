@@ -0,0 +1,54 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the TrackId value type, a Spotify ID stored as 128 bits
+*/
+#ifndef TRACKID_H
+#define TRACKID_H
+//include necessary libraries
+#include <string>
+#include <cstdint>
+#include <functional>
+
+using namespace std;
+
+//a Spotify ID is the base62 form of a 128 bit number, storing the number takes 16 bytes
+//instead of a 22 character string, and hashing or comparing it is two integer operations
+class TrackId {
+public:
+    //initialize public functions to be used in TrackId.cpp
+    TrackId() : high(0), low(0) {}
+    static TrackId fromBase62(const string& base62, bool* ok = nullptr);
+    static TrackId fromParts(uint64_t high, uint64_t low) { TrackId id; id.high = high; id.low = low; return id; }
+
+    string toBase62() const;
+    string toUri() const;
+    bool isValid() const { return (high | low) != 0; }
+    uint64_t getHigh() const { return high; }
+    uint64_t getLow() const { return low; }
+
+    bool operator==(const TrackId& other) const { return high == other.high && low == other.low; }
+    bool operator!=(const TrackId& other) const { return !(*this == other); }
+    bool operator<(const TrackId& other) const { return high != other.high ? high < other.high : low < other.low; }
+
+    size_t hash() const {
+        //the ID is already uniformly distributed, mixing the halves is enough
+        uint64_t mixed = high ^ (low * 0x9E3779B97F4A7C15ULL);
+        return static_cast<size_t>(mixed ^ (mixed >> 32));
+    }
+
+    static constexpr size_t base62Length = 22;
+
+private:
+    uint64_t high;
+    uint64_t low;
+};
+
+namespace std {
+template <>
+struct hash<TrackId> {
+    size_t operator()(const TrackId& id) const { return id.hash(); }
+};
+}
+
+#endif // TRACKID_H
@@ -0,0 +1,143 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class reads tracks.items[].track.id (or items[].track.id for a page of tracks)
+ *        with nlohmann's SAX interface, so no JSON tree is built for the whole playlist
+*/
+
+#include "TrackIdExtractor.h"
+
+/** @brief Constructor for the TrackIdExtractor class
+ * @param onTrackID called with each track ID in playlist order
+ */
+TrackIdExtractor::TrackIdExtractor(function<void(std::string&)> onTrackID) : onTrackID(move(onTrackID)), total(0) {}
+
+/** @brief runs the SAX parser over a payload
+ * @param payload the JSON response body
+ * @param onTrackID called with each track ID in playlist order
+ * @param total optional, receives the total number of tracks in the playlist
+ * @return true if the payload was valid JSON
+ */
+bool TrackIdExtractor::run(const std::string& payload, function<void(std::string&)> onTrackID, size_t* total) {
+    TrackIdExtractor handler(move(onTrackID));
+    bool valid = nlohmann::json::sax_parse(payload, &handler);
+    if (total) {
+        *total = handler.total;
+    }
+    return valid;
+}
+
+/** @brief extracts the track IDs of a playlist object or of a page of playlist tracks
+ * @param payload the JSON response body
+ * @param trackIDs vector that the IDs are appended to, in playlist order
+ * @param total optional, receives the total number of tracks in the playlist
+ * @return true if the payload was valid JSON
+ */
+bool TrackIdExtractor::extract(const std::string& payload, vector<std::string>& trackIDs, size_t* total) {
+    return run(payload, [&trackIDs](std::string& id) { trackIDs.push_back(move(id)); }, total);
+}
+
+/** @brief extracts the track IDs in their compact 16 byte form, IDs that fail to decode are skipped
+ * @param payload the JSON response body
+ * @param trackIDs vector that the IDs are appended to, in playlist order
+ * @param total optional, receives the total number of tracks in the playlist
+ * @return true if the payload was valid JSON
+ */
+bool TrackIdExtractor::extract(const std::string& payload, vector<TrackId>& trackIDs, size_t* total) {
+    return run(payload, [&trackIDs](std::string& id) {
+        bool ok;
+        TrackId trackID = TrackId::fromBase62(id, &ok);
+        if (ok) {
+            trackIDs.push_back(trackID);
+        }
+    }, total);
+}
+
+/** @brief enters an object or array, working out where it sits in the playlist
+ * @param isArray true when an array is opened
+ */
+void TrackIdExtractor::open(bool isArray) {
+    Scope parent = scopes.empty() ? Scope::Other : scopes.back();
+    Scope scope = Scope::Other;
+
+    if (scopes.empty()) {
+        scope = Scope::Root;
+    }
+    else if (parent == Scope::Root && currentKey == "tracks" && !isArray) {
+        scope = Scope::Tracks;
+    }
+    else if ((parent == Scope::Root || parent == Scope::Tracks) && currentKey == "items" && isArray) {
+        scope = Scope::Items;
+    }
+    else if (parent == Scope::Items && !isArray) {
+        scope = Scope::Item;
+    }
+    else if (parent == Scope::Item && currentKey == "track" && !isArray) {
+        scope = Scope::Track;
+    }
+    scopes.push_back(scope);
+    currentKey.clear();
+}
+
+/** @brief leaves the innermost object or array
+ */
+void TrackIdExtractor::close() {
+    scopes.pop_back();
+    currentKey.clear();
+}
+
+bool TrackIdExtractor::start_object(size_t) {
+    open(false);
+    return true;
+}
+
+bool TrackIdExtractor::end_object() {
+    close();
+    return true;
+}
+
+bool TrackIdExtractor::start_array(size_t) {
+    open(true);
+    return true;
+}
+
+bool TrackIdExtractor::end_array() {
+    close();
+    return true;
+}
+
+bool TrackIdExtractor::key(string_t& val) {
+    currentKey = val;
+    return true;
+}
+
+bool TrackIdExtractor::string(string_t& val) {
+    if (!scopes.empty() && scopes.back() == Scope::Track && currentKey == "id") {
+        onTrackID(val);
+    }
+    return true;
+}
+
+bool TrackIdExtractor::number_unsigned(number_unsigned_t val) {
+    if (!scopes.empty() && (scopes.back() == Scope::Root || scopes.back() == Scope::Tracks) && currentKey == "total") {
+        total = static_cast<size_t>(val);
+    }
+    return true;
+}
+
+bool TrackIdExtractor::number_integer(number_integer_t val) {
+    if (val >= 0) {
+        return number_unsigned(static_cast<number_unsigned_t>(val));
+    }
+    return true;
+}
+
+//values the extractor does not need
+bool TrackIdExtractor::null() { return true; }
+bool TrackIdExtractor::boolean(bool) { return true; }
+bool TrackIdExtractor::number_float(number_float_t, const string_t&) { return true; }
+bool TrackIdExtractor::binary(binary_t&) { return true; }
+
+bool TrackIdExtractor::parse_error(size_t, const std::string&, const nlohmann::detail::exception&) {
+    return false;
+}
@@ -0,0 +1,52 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the SAX handler that reads track IDs out of playlist responses
+*/
+#ifndef TRACKIDEXTRACTOR_H
+#define TRACKIDEXTRACTOR_H
+//include necessary libraries
+#include <string>
+#include <vector>
+#include <functional>
+#include "json.hpp"
+#include "TrackId.h"
+
+using namespace std;
+
+class TrackIdExtractor : public nlohmann::json_sax<nlohmann::json> {
+public:
+    //initialize public functions to be used in TrackIdExtractor.cpp
+    static bool extract(const std::string& payload, vector<std::string>& trackIDs, size_t* total = nullptr);
+    static bool extract(const std::string& payload, vector<TrackId>& trackIDs, size_t* total = nullptr);
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(size_t elements) override;
+    bool end_array() override;
+    bool parse_error(size_t position, const std::string& last_token, const nlohmann::detail::exception& ex) override;
+
+private:
+    //what the parser is currently inside of
+    enum class Scope { Root, Tracks, Items, Item, Track, Other };
+
+    explicit TrackIdExtractor(function<void(std::string&)> onTrackID);
+    static bool run(const std::string& payload, function<void(std::string&)> onTrackID, size_t* total);
+    void open(bool isArray);
+    void close();
+
+    function<void(std::string&)> onTrackID; //receives each ID as it is parsed
+    size_t total;
+    vector<Scope> scopes; //one entry per open object or array
+    std::string currentKey; //key of the value being read, empty inside arrays
+};
+
+#endif // TRACKIDEXTRACTOR_H
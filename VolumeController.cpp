@@ -0,0 +1,118 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This class turns the stream of slider values into volume requests: values that arrive while a
+ *        request is in flight are coalesced so only the latest is sent next, and the UI is reconciled
+ *        with the volume the device reports once the requests have settled
+*/
+
+#include "VolumeController.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <QPointer>
+
+/** @brief Constructor for the VolumeController class
+ * @param api used to send the volume requests, with its current access token
+ * @param initialPercent the volume the device had at start up
+ * @param parent owner of the controller, it must live on the GUI thread
+ */
+VolumeController::VolumeController(SpotifyAPI& api, int initialPercent, QObject* parent)
+    : QObject(parent), api(api), volume(initialPercent), waiting(-1), inFlight(false),
+      settledAt(Clock::now()), changes(0), sent(0), failed(0), reconciled(0), latencyMsTotal(0) {
+}
+
+/** @brief takes a new volume from the UI, it is sent now or once the request in flight completes
+ * @param percent the new volume
+ */
+void VolumeController::setVolume(int percent) {
+    changes++;
+    volume = percent;
+    if (inFlight) {
+        //an older waiting value is simply replaced, it would be overwritten straight away
+        waiting = percent;
+        return;
+    }
+    send(percent);
+}
+
+/** @brief selects the device whose volume is controlled, requests already sent are not affected
+ * @param deviceID the device, empty for whichever device is active
+ */
+void VolumeController::setDevice(const string& deviceID) {
+    this->deviceID = deviceID;
+}
+
+/** @brief sends one volume request, its completion is handled on the GUI thread
+ * @param percent the volume to send
+ */
+void VolumeController::send(int percent) {
+    inFlight = true;
+    sentAt = Clock::now();
+    sent++;
+    //the guard covers responses that are aborted while the window is being torn down
+    QPointer<VolumeController> self(this);
+    api.setVolumeAsync(api.getAccessToken(), percent, deviceID, [self, percent](HttpResponse response) {
+        bool ok = response.ok() && response.status < 300;
+        if (self) {
+            QMetaObject::invokeMethod(self.data(), [self, percent, ok]() { if (self) self->completed(percent, ok); },
+                                      Qt::QueuedConnection);
+        }
+    });
+}
+
+/** @brief handles a completed request and sends the latest waiting value, if any
+ * @param percent the volume that was sent
+ * @param ok false if the request failed
+ */
+void VolumeController::completed(int percent, bool ok) {
+    latencyMsTotal += chrono::duration<double, milli>(Clock::now() - sentAt).count();
+    if (!ok) {
+        failed++;
+        cerr << "Could not set the volume to " << percent << "%" << endl;
+    }
+    inFlight = false;
+    if (waiting >= 0 && waiting != percent) {
+        int next = waiting;
+        waiting = -1;
+        send(next);
+        return;
+    }
+    waiting = -1;
+    settledAt = Clock::now();
+    emit settled();
+}
+
+/** @brief compares the volume the device reports with the one shown
+ *  Reports read while a request was pending, or before the last one completed, are ignored since they
+ *  may not include the change yet.
+ * @param devicePercent volume reported by the device, negative if unknown
+ * @param readAt when the device state was read
+ */
+void VolumeController::reconcile(int devicePercent, chrono::steady_clock::time_point readAt) {
+    if (devicePercent < 0 || inFlight || readAt < settledAt || devicePercent == volume) {
+        return;
+    }
+    volume = devicePercent;
+    reconciled++;
+    emit volumeReconciled(devicePercent);
+}
+
+/** @brief getter method for the volume shown
+ * @return volume
+ */
+int VolumeController::getVolume() const {
+    return volume;
+}
+
+/** @brief builds a one line summary of the volume counters
+ * @return the summary
+ */
+string VolumeController::getStatsReport() const {
+    ostringstream report;
+    report << "Volume: " << changes << " changes, " << sent << " requests sent ("
+           << (changes > sent ? changes - sent : 0) << " coalesced), " << failed << " failed, "
+           << reconciled << " reconciled with the device, " << fixed << setprecision(1)
+           << (sent == 0 ? 0.0 : latencyMsTotal / sent) << " ms per request";
+    return report.str();
+}
@@ -0,0 +1,57 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief This header contains the variables, methods and signals of the VolumeController class
+*/
+#ifndef VOLUMECONTROLLER_H
+#define VOLUMECONTROLLER_H
+//include necessary libraries
+#include <string>
+#include <chrono>
+#include <QObject>
+#include "SpotifyAPI.h"
+
+using namespace std;
+
+//sends volume changes with at most one request in flight, the latest value always wins
+class VolumeController : public QObject {
+    Q_OBJECT
+
+public:
+    //initialize public functions to be used in VolumeController.cpp
+    VolumeController(SpotifyAPI& api, int initialPercent, QObject* parent = nullptr);
+
+    void setVolume(int percent);
+    void setDevice(const string& deviceID);
+    void reconcile(int devicePercent, chrono::steady_clock::time_point readAt);
+    int getVolume() const;
+    string getStatsReport() const;
+
+signals:
+    //the device reported a volume other than the one shown, the UI should show it
+    void volumeReconciled(int percent);
+    //the last request completed and nothing is waiting to be sent
+    void settled();
+
+private:
+    using Clock = chrono::steady_clock;
+
+    SpotifyAPI& api;
+    string deviceID; //device the requests target, empty for the active device
+    int volume; //what the UI shows, set before the device confirms it
+    int waiting; //value to send once the request in flight completes, -1 for none
+    bool inFlight;
+    Clock::time_point sentAt;
+    Clock::time_point settledAt; //device state read before this may not include our last change
+
+    size_t changes; //values received from the UI
+    size_t sent;
+    size_t failed;
+    size_t reconciled;
+    double latencyMsTotal;
+
+    void send(int percent);
+    void completed(int percent, bool ok);
+};
+
+#endif // VOLUMECONTROLLER_H
@@ -1,8 +1,9 @@
 QT       += core widgets network
+CONFIG += c++17
 TARGET = Application
 TEMPLATE = app 
-SOURCES += main.cpp mainwindow.cpp csvdata.cpp SpotifyAPI.cpp 
-HEADERS += mainwindow.h csvdata.h SpotifyAPI.h 
+SOURCES += main.cpp mainwindow.cpp csvdata.cpp SpotifyAPI.cpp CurlPool.cpp RequestEngine.cpp PlaylistWriter.cpp TrackIdExtractor.cpp Deduplicator.cpp TrackId.cpp TrackCache.cpp ResponseCache.cpp ArtworkCache.cpp ArtworkDownloader.cpp PlaybackScheduler.cpp PlaybackWorker.cpp FrameMonitor.cpp VolumeController.cpp PlaybackCommandQueue.cpp TokenManager.cpp AuthorizationListener.cpp StartupPipeline.cpp DeviceRegistry.cpp
+HEADERS += mainwindow.h csvdata.h SpotifyAPI.h CurlPool.h RequestEngine.h SpotifyTypes.h PlaylistWriter.h TrackIdExtractor.h Deduplicator.h TrackId.h TrackCache.h ResponseCache.h ArtworkCache.h ArtworkDownloader.h PlaybackScheduler.h PlaybackWorker.h FrameMonitor.h VolumeController.h PlaybackCommandQueue.h TokenManager.h AuthorizationListener.h StartupPipeline.h DeviceRegistry.h
 RESOURCES += resources.qrc
 INCLUDEPATH += $$PWD/externals/nlohmann_json
 # Adding the SSL and Crypto libraries
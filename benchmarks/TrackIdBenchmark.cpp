@@ -0,0 +1,108 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief Compares reading the track IDs of a large playlist by building the whole json tree with reading
+ *        them with TrackIdExtractor's SAX handler, timing both and measuring their peak heap use.
+ *        Standalone, from the repository root:
+ *          g++ -std=c++17 -O2 -I. -Iexternals/nlohmann_json benchmarks/TrackIdBenchmark.cpp TrackIdExtractor.cpp TrackId.cpp -o trackid_benchmark
+*/
+
+#include "TrackIdExtractor.h"
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using json = nlohmann::json;
+
+namespace {
+//bytes allocated while measuring, each block keeps its size in front of it so delete can subtract it
+size_t currentBytes = 0;
+size_t peakBytes = 0;
+bool measuring = false;
+constexpr size_t headerSize = 16; //keeps the returned blocks 16 byte aligned
+
+//the old extractTrackIDS, which builds the whole playlist as a json tree
+vector<string> extractWithTree(const string& playlistJson) {
+    json playlist = json::parse(playlistJson);
+    vector<string> ids;
+    for (const auto& item : playlist["tracks"]["items"]) {
+        if (item.contains("track") && item["track"].contains("id") && !item["track"]["id"].is_null()) {
+            ids.push_back(item["track"]["id"]);
+        }
+    }
+    return ids;
+}
+
+//a playlist object shaped like the Web API's, with the markets that make real responses large
+string buildPlaylist(int trackCount) {
+    json markets = json::array();
+    for (int m = 0; m < 80; m++) {
+        markets.push_back("M" + to_string(m));
+    }
+    json items = json::array();
+    for (int i = 0; i < trackCount; i++) {
+        json artists = json::array({{{"name", "Artist " + to_string(i)}, {"id", "a" + to_string(i)}}});
+        json images = json::array({{{"url", "https://i.scdn.co/image/x"}, {"width", 640}}});
+        json album = {{"name", "Album"}, {"images", images}, {"available_markets", markets}};
+        json track = {{"id", "4iV5W9uYEdYUVa79Axb7Rh"}, {"name", "Song " + to_string(i)}, {"artists", artists},
+                      {"available_markets", markets}, {"album", album}};
+        items.push_back({{"added_at", "2024-01-01"}, {"track", track}});
+    }
+    json playlist = {{"id", "p"}, {"tracks", {{"total", trackCount}, {"items", items}}}};
+    return playlist.dump();
+}
+}
+
+void* operator new(size_t size) {
+    char* block = static_cast<char*>(malloc(size + headerSize));
+    if (!block) {
+        throw bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    if (measuring) {
+        currentBytes += size;
+        peakBytes = max(peakBytes, currentBytes);
+    }
+    return block + headerSize;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) {
+        return;
+    }
+    char* block = static_cast<char*>(pointer) - headerSize;
+    if (measuring) {
+        currentBytes -= *reinterpret_cast<size_t*>(block);
+    }
+    free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+int main() {
+    string playlist = buildPlaylist(10000);
+    cout << "Playlist of 10000 tracks, " << playlist.size() / (1024 * 1024) << " MiB" << endl;
+
+    for (bool sax : {false, true}) {
+        currentBytes = 0;
+        peakBytes = 0;
+        measuring = true;
+        auto start = chrono::steady_clock::now();
+        vector<string> ids;
+        if (sax) {
+            TrackIdExtractor::extract(playlist, ids);
+        }
+        else {
+            ids = extractWithTree(playlist);
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        measuring = false;
+        cout << (sax ? "SAX (TrackIdExtractor): " : "DOM (json tree):        ") << ids.size() << " IDs in " << ms
+             << " ms, " << peakBytes / 1024 << " KiB peak heap" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * @author Jwalant Patel, Ross Cameron, Lance Cheong Youne, Ojas Singh Hunjan, Matthew Morelli
+ * @date 2026-10-18
+ * @brief Times parsing a 50 track response of the several tracks endpoint and converting it to Track
+ *        records, to show what the typed model costs on top of the parse.
+ *        Standalone, from the repository root:
+ *          g++ -std=c++17 -O2 -I. -Iexternals/nlohmann_json benchmarks/TrackModelBenchmark.cpp -o trackmodel_benchmark
+*/
+
+#include "SpotifyTypes.h"
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+using json = nlohmann::json;
+
+namespace {
+//a /v1/tracks response shaped like the Web API's, with the markets that make real responses large
+string buildResponse(int trackCount) {
+    json markets = json::array();
+    for (int m = 0; m < 80; m++) {
+        markets.push_back("M" + to_string(m));
+    }
+    json images = json::array({{{"url", "https://i/640"}, {"width", 640}, {"height", 640}},
+                               {{"url", "https://i/300"}, {"width", 300}, {"height", 300}},
+                               {{"url", "https://i/64"}, {"width", 64}, {"height", 64}}});
+    json artists = json::array({{{"id", "a"}, {"name", "Artist"}}, {{"id", "b"}, {"name", "Other"}}});
+    json tracks = json::array();
+    for (int i = 0; i < trackCount; i++) {
+        tracks.push_back({{"id", "4iV5W9uYEdYUVa79Axb7Rh"}, {"name", "Song " + to_string(i)},
+                          {"uri", "spotify:track:4iV5W9uYEdYUVa79Axb7Rh"}, {"duration_ms", 200000}, {"type", "track"},
+                          {"available_markets", markets}, {"artists", artists},
+                          {"album", {{"id", "al"}, {"name", "Album"}, {"available_markets", markets}, {"images", images}}}});
+    }
+    return json{{"tracks", tracks}}.dump();
+}
+}
+
+int main() {
+    const int rounds = 200;
+    string body = buildResponse(50);
+    double parseUs = 0;
+    double convertUs = 0;
+    size_t converted = 0;
+    for (int round = 0; round < rounds; round++) {
+        auto start = chrono::steady_clock::now();
+        json response = json::parse(body);
+        auto parsed = chrono::steady_clock::now();
+        vector<Track> tracks;
+        for (const auto& item : response["tracks"]) {
+            tracks.push_back(item.get<Track>());
+        }
+        auto done = chrono::steady_clock::now();
+        converted += tracks.size();
+        parseUs += chrono::duration<double, micro>(parsed - start).count();
+        convertUs += chrono::duration<double, micro>(done - parsed).count();
+    }
+    cout << "50 track response of " << body.size() << " bytes, averaged over " << rounds << " rounds:" << endl;
+    cout << "  parse:         " << parseUs / rounds << " us" << endl;
+    cout << "  json -> Track: " << convertUs / rounds << " us (" << convertUs / converted << " us per track)" << endl;
+    return 0;
+}
@@ -18,6 +18,11 @@ CsvData::CsvData(const string& filename){
     loadFromFile(filename);
 }
 
+/** @brief default constructor CsvData, creates an empty instance that a loaded one can be assigned to
+ */
+CsvData::CsvData(){
+}
+
 /** @brief print function used to debug code
  */
 void CsvData::printData() const{
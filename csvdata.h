@@ -13,6 +13,7 @@ using namespace std;
 class CsvData {
 public:
 //initialize public functions to be used in csvdata.cpp
+    CsvData();
     CsvData(const string& filename);
     void printData() const;
     vector<vector<string>> getData();
@@ -10,16 +10,13 @@ using json = nlohmann::json;
 /** @brief Constructor for the MainWindow class
  * @param parent pointer to the parent widget
  */
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), csvData("extras/responses.csv") ,spotifyApi(clientID, clientSecret) {
+MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), spotifyApi(clientID, clientSecret) {
 
-  outputPath = "externals/images";
+  // times the whole startup, from building the window to the last step
+  startup = new StartupPipeline(4, this);
   clientID = "";
   clientSecret = "";
 
-  createdPlaylist = spotifyApi.createPlaylist(clientID, "3307B Test Playlist");
-  accessToken = spotifyApi.getAccessToken();
-  deviceID = spotifyApi.getDeviceID();
-
   QWidget* centralWidget = new QWidget(this);
   mainLayout = new QVBoxLayout(centralWidget); // layout for the song widget
 
@@ -27,13 +24,29 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), csvData("extras/r
   trackIcon = new QPushButton(QIcon(""), "", this);
   trackIcon->setFixedSize(100, 100);
   currentTrack = new QLabel("Current Track: ", centralWidget);
+  trackProgress = new QLabel("", centralWidget);
   currentTrackLayout->addWidget(trackIcon);
   currentTrackLayout->addWidget(currentTrack);
-
-  updateTimer = new QTimer(this);
-  updateTimer->setInterval(3000); //3000ms (3 seconds)
-  connect(updateTimer, &QTimer::timeout, this, &MainWindow::updateCurrentTrack);
-  updateTimer->start(); // start the timer
+  currentTrackLayout->addWidget(trackProgress);
+
+  // the playback state is polled and parsed on its own thread and arrives here as snapshots,
+  // the next poll is timed from the playback progress, see PlaybackScheduler
+  playbackWorker = new PlaybackWorker(spotifyApi);
+  playbackWorker->moveToThread(&playbackThread);
+  connect(&playbackThread, &QThread::started, playbackWorker, &PlaybackWorker::start);
+  connect(playbackWorker, &PlaybackWorker::snapshotReady, this, &MainWindow::showPlayback, Qt::QueuedConnection);
+
+  // commands name the device they go to, its state is polled once they have been applied
+  deviceRegistry = new DeviceRegistry(spotifyApi, 30000, this);
+  playbackCommands = new PlaybackCommandQueue(spotifyApi, this);
+  connect(playbackCommands, &PlaybackCommandQueue::settled, this, &MainWindow::pollSoon);
+  connect(playbackCommands, &PlaybackCommandQueue::commandFailed, deviceRegistry, &DeviceRegistry::refreshAsync);
+
+  // between polls the progress is estimated locally
+  progressTimer = new QTimer(this);
+  progressTimer->setInterval(1000);
+  connect(progressTimer, &QTimer::timeout, this, &MainWindow::showTrackProgress);
+  progressTimer->start();
 
   mergedPlaylistLayout = new QVBoxLayout();
 
@@ -46,25 +59,30 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), csvData("extras/r
   scrollArea->setWidget(containerWidget);
   scrollArea->setWidgetResizable(true);
   scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+
+  // covers are downloaded in the background, visible rows first, and set on their rows when ready
+  artworkDownloader = new ArtworkDownloader("externals/cache/artwork", 100, 4, 8 * 1024, this);
+  connect(artworkDownloader, &ArtworkDownloader::artworkReady, this, &MainWindow::artworkReady);
+  connect(scrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::updateVisibleRows);
+  connect(scrollArea->verticalScrollBar(), &QScrollBar::rangeChanged, this, &MainWindow::updateVisibleRows);
  
   // initalize the secondary layout for buttons (play, pause, create playlist, share playlist)
   buttonLayout = new QHBoxLayout; 
   playButton = new QPushButton("Play", centralWidget);
-  playButton->installEventFilter(this);
   pauseButton = new QPushButton("Pause", centralWidget);
-  pauseButton->installEventFilter(this);
   createPlaylist = new QPushButton("Create Playlist", centralWidget);
-  createPlaylist->installEventFilter(this);
   sharePlaylist = new QPushButton("Share Playlist", centralWidget);
-  sharePlaylist->installEventFilter(this);
   sharePlaylist->hide();
   playPlaylist = new QPushButton("Play Playlist", centralWidget);
-  playPlaylist->installEventFilter(this);
   
   // set up volume slider
   volumeSlider = new QSlider(Qt::Horizontal, centralWidget);
   volumeSlider->setRange(0,100);
-  volumeSlider->setValue(spotifyApi.getVolumePercent());
+  // the slider moves right away, the controller catches up with it one request at a time
+  volumeController = new VolumeController(spotifyApi, volumeSlider->value(), this);
+  connect(volumeController, &VolumeController::volumeReconciled, this, &MainWindow::showVolume);
+  connect(volumeController, &VolumeController::settled, this, &MainWindow::pollSoon);
+  connect(deviceRegistry, &DeviceRegistry::targetChanged, this, &MainWindow::showDevice);
 
   // connect the buttons to the functions through clicks
   connect(playButton, &QPushButton::clicked, this, &MainWindow::playButtonClicked);
@@ -89,24 +107,203 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), csvData("extras/r
   mainLayout->addWidget(volumeSlider);
 
   setCentralWidget(centralWidget);
+
+  // the stall measurement and the counters printed on exit are only wanted while profiling,
+  // the frame timer would otherwise wake the GUI thread every 16 ms for the whole session
+  diagnostics = getenv("SPOTIFY_CONTROLLER_DIAGNOSTICS") != nullptr;
+  frameMonitor = diagnostics ? new FrameMonitor(this) : nullptr;
+
+  // the controls that need the user's token are enabled by the startup steps they depend on
+  for (QWidget* control : {static_cast<QWidget*>(playButton), static_cast<QWidget*>(pauseButton),
+                           static_cast<QWidget*>(createPlaylist), static_cast<QWidget*>(playPlaylist),
+                           static_cast<QWidget*>(volumeSlider)}) {
+    control->setEnabled(false);
+  }
+  // the refresh can fail this way from a startup step or the refresher thread, the window is reached
+  // through a queued call and may be gone by then
+  QPointer<MainWindow> self(this);
+  spotifyApi.setAuthorizationLostHandler([self]() {
+    QMetaObject::invokeMethod(self.data(), [self]() { if (self) self->authorizationLost(); }, Qt::QueuedConnection);
+  });
+  addStartupSteps();
+  startup->mark("window built");
+  // the steps start once the event loop runs, so the window is shown first
+  QTimer::singleShot(0, startup, &StartupPipeline::start);
+}
+
+/** @brief builds the startup dependency graph, independent steps run at the same time:
+ *
+ *    csv, warm up ----------------------------------------+
+ *    stored token -> authorization -+-> user ID -> playlist -+-> playlist controls
+ *                                   +-> devices -> volume
+ *                                   +-> playback
+ */
+void MainWindow::addStartupSteps() {
+  startup->addStep("csv", {}, [this]() {
+    csvData = CsvData("extras/responses.csv");
+    return true;
+  });
+  startup->addStep("warm up", {}, [this]() {
+    spotifyApi.warmUp();
+    return true;
+  });
+  // an expired stored token is refreshed here, off the GUI thread
+  startup->addStep("stored token", {}, [this]() {
+    spotifyApi.ensureUserToken();
+    return true;
+  });
+  startup->addPendingStep("authorization", {"stored token"}, [this](function<void(bool)> done) {
+    authorize([this, done](bool ok) {
+      done(ok);
+      if (!ok) offerAuthorizationRetry();
+    });
+  });
+  startup->addStep("user ID", {"authorization"}, [this]() {
+    return !spotifyApi.getUserID().empty();
+  });
+  startup->addStep("devices", {"authorization"}, [this]() {
+    deviceRegistry->refresh();
+    return true;
+  });
+  startup->addStep("playlist", {"user ID"}, [this]() {
+    createdPlaylist = spotifyApi.createPlaylist("3307B Test Playlist");
+    return !createdPlaylist.empty();
+  });
+  startup->addStep("playback", {"authorization"}, [this]() {
+    playButton->setEnabled(true);
+    pauseButton->setEnabled(true);
+    currentTrack->setText("Current Track: ");
+    playbackThread.start();
+    nowPlayingClock.start();
+    return true;
+  }, StartupPipeline::Gui);
+  startup->addStep("volume", {"devices"}, [this]() {
+    showDevice(deviceRegistry->getTargetDeviceID());
+    deviceRegistry->start();
+    return true;
+  }, StartupPipeline::Gui);
+  startup->addStep("playlist controls", {"playlist", "csv"}, [this]() {
+    createPlaylist->setEnabled(true);
+    playPlaylist->setEnabled(true);
+    return true;
+  }, StartupPipeline::Gui);
+  connect(startup, &StartupPipeline::finished, this, [this]() { cout << startup->getReport() << endl; });
+}
+
+/** @brief completes right away with a usable token, otherwise opens the authorize page in the browser
+ *  and waits for its redirect, the window stays responsive meanwhile
+ * @param done called with true once the user is authorized
+ */
+void MainWindow::authorize(function<void(bool)> done) {
+  if (spotifyApi.hasUserToken()) {
+    done(true);
+    return;
+  }
+  authorizationWaiters.push_back(done);
+  if (authorizationWaiters.size() > 1) {
+    // the authorize page is already open, this waits for the same redirect
+    return;
+  }
+  if (authorizationListener) {
+    // the previous authorization has finished long ago, including the page it sent
+    authorizationListener->deleteLater();
+  }
+  authorizationListener = new AuthorizationListener(3000, this);
+  if (!authorizationListener->listen()) {
+    // the redirect cannot be captured, so the code is pasted instead
+    authorizationDone(spotifyApi.authorizeWithPastedCode(clientID));
+    return;
+  }
+  connect(authorizationListener, &AuthorizationListener::codeReceived, this, &MainWindow::authorizationCodeReceived);
+  connect(authorizationListener, &AuthorizationListener::authorizationFailed, this, &MainWindow::authorizationFailed);
+
+  string authUrl = spotifyApi.getAuthorizeUrl(clientID, authorizationListener->getRedirectUri(), authorizationListener->getState());
+  cout << authUrl << endl;
+  QDesktopServices::openUrl(QUrl(QString::fromStdString(authUrl)));
+  currentTrack->setText("Current Track: waiting for authorization in the browser");
+}
+
+/** @brief exchanges the code captured by the listener for a token, without blocking the GUI thread
+ * @param code the authorization code
+ */
+void MainWindow::authorizationCodeReceived(const QString& code) {
+  // the listener is closed by now but kept, deleting it could cut off the page it is still sending
+  // the exchange completes on the request engine thread, the window may be closed by then
+  QPointer<MainWindow> self(this);
+  spotifyApi.exchangeAuthCodeAsync(code.toStdString(), authorizationListener->getRedirectUri(), [self](bool ok) {
+    QMetaObject::invokeMethod(self.data(), [self, ok]() { if (self) self->authorizationDone(ok); }, Qt::QueuedConnection);
+  });
+}
+
+/** @brief completes every caller waiting for the authorization
+ * @param ok true if the user is authorized
+ */
+void MainWindow::authorizationDone(bool ok) {
+  vector<function<void(bool)>> waiting;
+  waiting.swap(authorizationWaiters);
+  for (auto& waiter : waiting) {
+    waiter(ok);
+  }
+}
+
+/** @brief the refresh token was revoked, so the user is sent through the authorize page again
+ *  instead of the refresh being retried forever
+ */
+void MainWindow::authorizationLost() {
+  authorize([this](bool ok) {
+    if (!ok) offerAuthorizationRetry();
+  });
+}
+
+/** @brief asks the user whether to authorize again once an authorization has failed, the startup steps
+ *  that were skipped for lack of a token run again after it succeeds
+ */
+void MainWindow::offerAuthorizationRetry() {
+  currentTrack->setText("Current Track: not authorized");
+  // the startup step and a revoked token can fail together, the user is asked once
+  if (authorizationRetryOffered) {
+    return;
+  }
+  authorizationRetryOffered = true;
+  // asked once the waiters have been completed, so the dialog does not run inside their loop
+  QTimer::singleShot(0, this, [this]() {
+    bool again = QMessageBox::warning(this, "Authorization", "Spotify Controller is not authorized, most controls stay disabled.",
+                                      QMessageBox::Retry | QMessageBox::Cancel) == QMessageBox::Retry;
+    authorizationRetryOffered = false;
+    if (!again) {
+      return;
+    }
+    // the startup step is retried when it was the one that failed, otherwise the token was lost later on
+    if (!startup->retry("authorization")) {
+      authorizationLost();
+    }
+  });
+}
+
+/** @brief the user denied access, the steps that need the token are skipped
+ * @param error the error sent by the accounts service
+ */
+void MainWindow::authorizationFailed(const QString& error) {
+  cerr << "Authorization failed: " << error.toStdString() << endl;
+  authorizationDone(false);
 }
 
 /** @brief void function that resumes the song playback when the play button is clicked
  */ 
 void MainWindow::playButtonClicked() {
-  spotifyApi.resumePlayback(accessToken);
+  playbackCommands->enqueue(deviceRegistry->getTargetDeviceID(), PlaybackCommand::resume());
 }
 
 /** @brief void function that pauses the song playback when the play button is clicked
  */ 
 void MainWindow::pauseButtonClicked() {
-  spotifyApi.pauseTrackOnSpotify(accessToken);
+  playbackCommands->enqueue(deviceRegistry->getTargetDeviceID(), PlaybackCommand::pause());
 }
 
 /** @brief void function that plays the playlist when the play button is clicked
  */ 
 void MainWindow::playPlaylistButtonClicked() {
-  spotifyApi.playPlaylistOnSpotify(accessToken,"spotify:playlist:" + createdPlaylist);
+  playbackCommands->enqueue(deviceRegistry->getTargetDeviceID(), PlaybackCommand::playContext("spotify:playlist:" + createdPlaylist));
 }
 
 /** @brief function calls the spotify API to play the track if the play button is clicked
@@ -115,12 +312,15 @@ void MainWindow::trackPlayButtonClicked() {
   QPushButton* button = qobject_cast<QPushButton*>(sender());
 
   if(button){
-    QString trackId = button->property("trackId").toString();   
+    QString trackId = button->property("trackID").toString();
     // Check if the track ID is not empty
     string trackID = trackId.toStdString();
-    
-    // Call Spotify API to play the track
-    spotifyApi.playTrackOnSpotify(accessToken, trackID);
+    if(trackID.empty()){
+      return;
+    }
+
+    // queue the track, a track clicked before it is dropped if it has not been sent yet
+    playbackCommands->enqueue(deviceRegistry->getTargetDeviceID(), PlaybackCommand::playTrack(trackID));
   }
 }
 
@@ -131,90 +331,322 @@ void MainWindow::sharePlaylistClicked() {
   cout << "Created Playlist: https://open.spotify.com/playlist/" + createdPlaylist << endl;
 }
 
-/** @brief function calls to merge and create a playlist when the create button is clicked
+/** @brief function calls to merge and create a playlist when the create button is clicked,
+ *  the playlists and tracks are read on the request engine thread and the rows are added once they arrive
  */
 void MainWindow::createPlaylistClicked() {
   createPlaylist->hide();
   sharePlaylist->show();
 
   vector<string> trackURLs = csvData.getURLs();
-
+  // the token is read once here, it stays valid for much longer than the merge takes
+  string accessToken = spotifyApi.getAccessToken();
+
+  // state shared by the callbacks of the merge, they run on the request engine thread
+  struct Merge {
+    mutex readsMutex;
+    vector<PlaylistTrackIds> reads; // in the order the playlists were submitted
+    size_t remaining = 0;
+    Deduplicator deduplicator; // a playlist submitted more than once is only fetched the first time
+    size_t bytesBefore = 0;
+  };
+  auto merge = make_shared<Merge>();
+  merge->bytesBefore = spotifyApi.getBytesReceived();
+  vector<string> playlistIDs;
   for(const auto& url : trackURLs){
     string playlistID = spotifyApi.extractPlaylistID(url);
-    string playlistDetailsJson = spotifyApi.getPlaylistDetails(accessToken, playlistID);
-    vector<string> tracks = spotifyApi.extractTrackIDS(playlistDetailsJson);
-
-    for (const string& id : tracks) {
-      // each row has its own QHBoxLayout
-      QHBoxLayout *rowLayout = new QHBoxLayout();
-      QPushButton *label = new QPushButton();
-      QPushButton* button = new QPushButton(QIcon(""), "", this);
-      connect(button, &QPushButton::clicked, this, &MainWindow::trackPlayButtonClicked);
-      button->setFixedSize(100, 100);
-      button->installEventFilter(this);
-
-      // call the spotify API to get the track details (accessToken and id)
-      string trackJson = spotifyApi.getTrackDetails(accessToken, id);
-      auto trackDetails = json::parse(trackJson);
-
-      string trackName = trackDetails["name"];
-      string trackID = trackDetails["id"];
-      string artists = "";
-      for (auto& artist : trackDetails["artists"]) {
-        if (!artists.empty()) artists += ", ";
-        artists += artist["name"].get<string>();
+    if(merge->deduplicator.addPlaylist(playlistID)){
+      playlistIDs.push_back(playlistID);
+    }
+  }
+  merge->reads.resize(playlistIDs.size());
+  merge->remaining = playlistIDs.size();
+
+  // the window may be closed before the reads return, so it is only reached through a queued call
+  QPointer<MainWindow> self(this);
+  SpotifyAPI* api = &spotifyApi;
+  auto readsDone = [self, api, merge, accessToken]() {
+    // collect the track IDs of every playlist, keeping only the first occurrence of each track,
+    // then fetch their details in batches
+    vector<TrackId> trackIDs;
+    size_t readCount = 0;
+    bool complete = true;
+    for(const PlaylistTrackIds& read : merge->reads){
+      complete = complete && read.complete;
+      readCount += read.ids.size();
+      merge->deduplicator.reserveTracks(read.ids.size());
+      for(const TrackId& id : read.ids){
+        if(merge->deduplicator.addTrack(id)){
+          trackIDs.push_back(id);
+        }
       }
-      // create the label and button for the current row
-      label->setText(QString::fromStdString("Track: " + trackName + " - " + artists));
-      button->setProperty("trackID", QString::fromStdString(trackID));
-      spotifyApi.downloadTrackImg(trackJson, trackID, outputPath);
-      spotifyApi.addTrackToPlaylist(accessToken, createdPlaylist, "spotify:track:" + trackID);
-      button->setIcon(QIcon(QString::fromStdString("externals/images/" + trackID + ".png")));
-      button->setIconSize(QSize(100,100));
-
-      // add the label and button to the row layout
-      rowLayout->addWidget(button);
-      rowLayout->addWidget(label);
-
-      // add the current row layout to the rows layout
-      mergedPlaylistLayout->addLayout(rowLayout);
     }
+    cout << "Read " << readCount << " track IDs from " << merge->reads.size() << " playlists using "
+         << (api->getBytesReceived() - merge->bytesBefore) / 1024 << " KiB" << endl;
+    cout << merge->deduplicator.getReport() << endl;
+    if(!complete){
+      QMetaObject::invokeMethod(self.data(), [self]() { if (self) self->mergeFailed(); }, Qt::QueuedConnection);
+      return;
+    }
+    api->getSeveralTracksAsync(accessToken, trackIDs, [self, accessToken](bool ok, vector<Track> tracks) {
+      QMetaObject::invokeMethod(self.data(), [self, accessToken, ok, tracks]() {
+        if (!self) return;
+        if (ok) self->showMergedTracks(accessToken, tracks);
+        else self->mergeFailed();
+      }, Qt::QueuedConnection);
+    });
+  };
+
+  // every page of every playlist is requested up front so they download concurrently,
+  // only the track IDs are requested since the details come from the batched track lookup
+  if(playlistIDs.empty()){
+    readsDone();
+    return;
+  }
+  for(size_t index = 0; index < playlistIDs.size(); index++){
+    spotifyApi.getPlaylistTrackIDsAsync(accessToken, playlistIDs[index], PlaylistFields::IdsOnly,
+                                        [merge, index, readsDone](PlaylistTrackIds read) {
+      {
+        lock_guard<mutex> lock(merge->readsMutex);
+        merge->reads[index] = move(read);
+        if(--merge->remaining != 0){
+          return;
+        }
+      }
+      readsDone();
+    });
+  }
+}
+
+/** @brief function adds a row for every merged track and writes them to the created playlist,
+ *  the writes are sent in the background
+ * @param accessToken token the merge was started with
+ * @param tracks the merged tracks, in playlist order
+ */
+void MainWindow::showMergedTracks(const string& accessToken, const vector<Track>& tracks) {
+  auto playlistWriter = make_shared<PlaylistWriter>(spotifyApi, accessToken, createdPlaylist);
+
+  for (const Track& track : tracks) {
+    // each row has its own QHBoxLayout
+    QHBoxLayout *rowLayout = new QHBoxLayout();
+    QPushButton *label = new QPushButton();
+    QPushButton* button = new QPushButton(QIcon(""), "", this);
+    connect(button, &QPushButton::clicked, this, &MainWindow::trackPlayButtonClicked);
+    button->setFixedSize(100, 100);
+
+    // create the label and button for the current row
+    label->setText(QString::fromStdString("Track: " + track.name + " - " + track.artistNames()));
+    button->setProperty("trackID", QString::fromStdString(track.id));
+    playlistWriter->add(track.uri);
+    // the icon is set once the cover is downloaded, rows of the same album share one download
+    rowsByArtwork[track.imageUrl(artworkDownloader->getThumbnailSize())].push_back(button);
+    button->setIconSize(QSize(100,100));
+
+    // add the label and button to the row layout
+    rowLayout->addWidget(button);
+    rowLayout->addWidget(label);
+
+    // add the current row layout to the rows layout
+    mergedPlaylistLayout->addLayout(rowLayout);
   }
+  // a failed write stops the rest, the user is told how far the playlist got
+  QPointer<MainWindow> self(this);
+  size_t total = tracks.size();
+  playlistWriter->flush([self, playlistWriter, total](bool ok) {
+    cout << playlistWriter->getThroughputReport() << endl;
+    if (!ok) {
+      size_t added = playlistWriter->getTrackCount();
+      QMetaObject::invokeMethod(self.data(), [self, added, total]() { if (self) self->writeFailed(added, total); },
+                                Qt::QueuedConnection);
+    }
+  });
+  updateVisibleRows();
+}
+
+/** @brief function tells the user the merged tracks could not all be written to the created playlist
+ * @param added tracks written before the failed write
+ * @param total tracks of the merge
+ */
+void MainWindow::writeFailed(size_t added, size_t total) {
+  QMessageBox::warning(this, "Create Playlist", QString::fromStdString("Only " + to_string(added) + " of " + to_string(total) +
+                       " tracks could be added to the playlist, the rest were not sent. Please try again."));
+}
+
+/** @brief function tells the user the merge could not read every playlist or track, nothing is written
+ *  since a partial merge would look like a finished one
+ */
+void MainWindow::mergeFailed() {
+  QMessageBox::warning(this, "Create Playlist", "Some playlists or tracks could not be read, nothing was added. Please try again.");
+  sharePlaylist->hide();
+  createPlaylist->show();
 }
 
-/** @brief function calls the spotify API to change the volume of the playback on the device connected when detected
+/** @brief function changes the volume of the playback on the device connected when detected,
+ *  values arriving while a request is in flight are coalesced so dragging the slider never queues requests
  */
 void MainWindow::onVolumeChanged(int value) {
-  spotifyApi.setVolume(accessToken, value);
+  volumeController->setVolume(value);
+}
+
+/** @brief function moves the volume slider to the volume reported by the device, without sending it back
+ * @param percent the device volume
+ */
+void MainWindow::showVolume(int percent) {
+  QSignalBlocker blocker(volumeSlider);
+  volumeSlider->setValue(percent);
+}
+
+/** @brief function points the volume slider at the device commands are sent to, it is only enabled
+ *  if that device accepts volume changes
+ * @param deviceID the device, empty if none can be targeted
+ */
+void MainWindow::showDevice(const string& deviceID) {
+  volumeController->setDevice(deviceID);
+  Device device;
+  bool adjustable = deviceRegistry->lookup(deviceID, device) && device.supportsVolume;
+  if (adjustable && device.volumePercent >= 0) {
+    showVolume(device.volumePercent);
+  }
+  volumeSlider->setEnabled(adjustable);
 }
 
 /** @brief function keeps the current track UI updated with the song currently being played on the device connected
  */
-void MainWindow::updateCurrentTrack() {
-  string currentlyPlayingJson = spotifyApi.getCurrentTrack(accessToken);
-
-  auto currentlyPlaying = json::parse(currentlyPlayingJson);
-  if (!currentlyPlaying.is_null() && currentlyPlaying.contains("item") && currentlyPlaying["item"].contains("name")) {
-    string trackName = currentlyPlaying["item"]["name"];
-    string trackID = currentlyPlaying["item"]["id"];
-    string artists = "";
-    for (auto& artist : currentlyPlaying["item"]["artists"]) {
-      if (!artists.empty()) artists += ", ";
-      artists += artist["name"].get<string>();
+void MainWindow::showPlayback(PlaybackSnapshotPtr snapshot) {
+  QElapsedTimer showTimer;
+  showTimer.start();
+  playback = snapshot;
+  deviceRegistry->notePlayback(snapshot->state.deviceID, snapshot->state.volumePercent);
+  // the volume of another device says nothing about the one the slider controls
+  if (snapshot->state.deviceID == deviceRegistry->getTargetDeviceID()) {
+    volumeController->reconcile(snapshot->state.volumePercent, snapshot->polledAt);
+  }
+
+  // the label and artwork only change when the track does, most snapshots end here
+  if (snapshot->trackChanged) {
+    const Track& track = snapshot->state.track;
+    currentTrack->setText(QString::fromStdString("Current Track: " + track.name + " - " + track.artistNames()));
+    string imageUrl = track.imageUrl(artworkDownloader->getThumbnailSize());
+    if (imageUrl != nowPlayingArtwork) {
+      nowPlayingArtwork = imageUrl;
+      artworkDownloader->request(nowPlayingArtwork, ArtworkDownloader::NowPlaying);
+    }
+    nowPlayingChanges++;
+  }
+  showTrackProgress();
+  nowPlayingUpdateNs += showTimer.nsecsElapsed();
+}
+
+/** @brief function shows the progress of the current track, estimated from the last poll
+ */
+void MainWindow::showTrackProgress() {
+  auto format = [](int ms) {
+    int seconds = ms / 1000;
+    ostringstream text;
+    text << seconds / 60 << ":" << setw(2) << setfill('0') << seconds % 60;
+    return text.str();
+  };
+  if (!playback || !playback->state.hasTrack) {
+    trackProgress->setText("");
+    return;
+  }
+  trackProgress->setText(QString::fromStdString(format(playback->progressMs()) + " / " +
+                                                format(playback->state.track.durationMs)));
+}
+
+/** @brief function polls the playback state shortly after a playback command, since it is likely to have changed
+ */
+void MainWindow::pollSoon() {
+  QMetaObject::invokeMethod(playbackWorker, &PlaybackWorker::pollSoon, Qt::QueuedConnection);
+}
+
+/** @brief function polls right away when the window is restored, polls are sparse while it is minimized
+ * @param event the state change
+ */
+void MainWindow::changeEvent(QEvent *event) {
+  if (event->type() == QEvent::WindowStateChange) {
+    bool visible = !isMinimized();
+    PlaybackWorker* worker = playbackWorker;
+    QMetaObject::invokeMethod(worker, [worker, visible]() { worker->setVisible(visible); }, Qt::QueuedConnection);
+  }
+  QMainWindow::changeEvent(event);
+}
+
+/** @brief builds a one line summary of the now playing refresh counters
+ * @return the summary
+ */
+string MainWindow::getNowPlayingReport() const {
+  if (!playback || playback->polls == 0) {
+    return "Now playing: no refreshes";
+  }
+  size_t polls = playback->polls;
+  double minutes = max(nowPlayingClock.elapsed() / 60000.0, 1.0 / 60.0);
+  ostringstream report;
+  report << "Now playing: " << polls << " refreshes (" << playback->guiThreadPolls << " on the GUI thread), "
+         << nowPlayingChanges << " track changes, " << fixed << setprecision(2)
+         << playback->pollNs / 1e6 / polls << " ms worker time and "
+         << nowPlayingUpdateNs / 1e6 / polls << " ms GUI time per refresh, "
+         << polls / minutes << " refreshes per minute, track ends seen after "
+         << playback->averageDetectionMs << " ms on average";
+  return report.str();
+}
+
+/** @brief function requests the covers of the rows on screen and of the rows a screen away from them,
+ *         and cancels the covers of rows that have scrolled further away
+ */
+void MainWindow::updateVisibleRows() {
+  QRect visible = scrollArea->viewport()->rect();
+  QRect nearby = visible.adjusted(0, -visible.height(), 0, visible.height());
+
+  for (const auto& entry : rowsByArtwork) {
+    if (entry.first.empty() || loadedArtwork.count(entry.first)) {
+      continue;
+    }
+    bool onScreen = false;
+    bool inRange = false;
+    for (QPushButton* button : entry.second) {
+      QRect rect(button->mapTo(scrollArea->viewport(), QPoint(0, 0)), button->size());
+      onScreen = onScreen || rect.intersects(visible);
+      inRange = inRange || rect.intersects(nearby);
+    }
+    if (onScreen) {
+      artworkDownloader->request(entry.first, ArtworkDownloader::Visible);
+    }
+    else if (inRange) {
+      artworkDownloader->request(entry.first, ArtworkDownloader::Nearby);
+    }
+    else if (entry.first != nowPlayingArtwork) {
+      // the current track label shows this cover too, so it is still needed while off screen
+      artworkDownloader->cancel(entry.first);
     }
-    currentTrack->setText(QString::fromStdString("Current Track: " + trackName + " - " + artists));
-    string trackJson = spotifyApi.getTrackDetails(accessToken, trackID);
-    spotifyApi.downloadTrackImg(trackJson, trackID, outputPath);
-    trackIcon->setIcon(QIcon(QString::fromStdString("externals/images/" + trackID + ".png")));
-    trackIcon->setIconSize(QSize(100,100));
   }
 }
 
-/** @brief event filter for when buttons are pressed
+/** @brief function sets a downloaded cover on every row showing it, and on the current track if it is its cover
+ * @param imageUrl url of the cover
+ * @param thumbnail the cover scaled to the icon size, shared by every row of the same album
  */
-bool MainWindow::eventFilter(QObject *obj, QEvent *event) {
-  return QObject::eventFilter(obj, event);
+void MainWindow::artworkReady(const QString& imageUrl, const QPixmap& thumbnail) {
+  string url = imageUrl.toStdString();
+  QIcon icon(thumbnail);
+  if (url == nowPlayingArtwork) {
+    trackIcon->setIcon(icon);
+    trackIcon->setIconSize(QSize(100,100));
+  }
+  auto rows = rowsByArtwork.find(url);
+  if (rows != rowsByArtwork.end()) {
+    for (QPushButton* button : rows->second) {
+      button->setIcon(icon);
+    }
+    loadedArtwork.insert(url);
+  }
 }
 
-//Destructor 
-MainWindow::~MainWindow() {}
+//Destructor, the playback worker uses spotifyApi so its thread is stopped first
+MainWindow::~MainWindow() {
+  // the worker steps use the members, so they finish before anything is destroyed
+  delete startup;
+  playbackThread.quit();
+  playbackThread.wait();
+  delete playbackWorker;
+}
@@ -11,6 +11,23 @@
 #include <QMainWindow>
 #include "csvdata.h"
 #include "SpotifyAPI.h"
+#include "PlaylistWriter.h"
+#include "Deduplicator.h"
+#include "ArtworkDownloader.h"
+#include "PlaybackWorker.h"
+#include "FrameMonitor.h"
+#include "VolumeController.h"
+#include "PlaybackCommandQueue.h"
+#include "AuthorizationListener.h"
+#include "StartupPipeline.h"
+#include "DeviceRegistry.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <QPointer>
+#include <QDesktopServices>
+#include <QUrl>
+#include <QThread>
 #include <QMainWindow>
 #include <QPushButton>
 #include <QString>
@@ -21,13 +38,21 @@
 #include <QSlider>
 #include "json.hpp"
 #include <iostream>
+#include <sstream>
+#include <iomanip>
 #include <vector>
 #include <string>
 #include <QListWidget>
 #include <QTimer>
 #include <QLabel>
 #include <QIcon>
+#include <QImage>
+#include <QPixmap>
+#include <QElapsedTimer>
 #include <QScrollArea>
+#include <QScrollBar>
+#include <map>
+#include <set>
 #include <stdlib.h>
 #include <QMessageBox>
 
@@ -41,12 +66,10 @@ public:
   MainWindow(QWidget *parent = nullptr);
   ~MainWindow();
 
-protected:
-    bool eventFilter(QObject *obj, QEvent *event) override;
-
 public slots:
   void onVolumeChanged(int value);
-  void updateCurrentTrack();
+  void showPlayback(PlaybackSnapshotPtr snapshot);
+  void showTrackProgress();
   void trackPlayButtonClicked();
 
 private slots:
@@ -55,14 +78,14 @@ private slots:
   void createPlaylistClicked();
   void sharePlaylistClicked();
   void playPlaylistButtonClicked();
+  void updateVisibleRows();
+  void artworkReady(const QString& imageUrl, const QPixmap& thumbnail);
+  void authorizationCodeReceived(const QString& code);
+  void authorizationFailed(const QString& error);
     
 private: 
-  string accessToken;
-  string deviceID;
-  string trackID;
   string clientID;
   string clientSecret;
-  string filename;
   CsvData csvData;
   SpotifyAPI spotifyApi;
   string createdPlaylist;
@@ -76,10 +99,44 @@ private:
 
   QHBoxLayout* buttonLayout;
 
-  QString outputPath;
   QLabel* currentTrack;
+  QLabel* trackProgress;
   QPushButton* trackIcon;
-  QTimer* updateTimer;
+  QTimer* progressTimer; // refreshes trackProgress from the interpolated progress, without polling
+  QThread playbackThread; // polls the playback state so the GUI thread never waits for it
+  PlaybackWorker* playbackWorker;
+  PlaybackSnapshotPtr playback; // latest playback state, published by playbackWorker
+  bool diagnostics = false; // SPOTIFY_CONTROLLER_DIAGNOSTICS is set
+  FrameMonitor* frameMonitor; // only created with diagnostics
+  void pollSoon();
+  PlaybackCommandQueue* playbackCommands; // sends the play and pause clicks in order, off the GUI thread
+  DeviceRegistry* deviceRegistry; // cached devices of the user and the one commands are sent to
+  void showDevice(const string& deviceID);
+  AuthorizationListener* authorizationListener = nullptr; // captures the redirect of the latest authorization
+  // completed once the user is authorized, the startup step and a revoked token can wait at the same time
+  vector<function<void(bool)>> authorizationWaiters;
+  void authorize(function<void(bool)> done);
+  void authorizationDone(bool ok);
+  void authorizationLost();
+  bool authorizationRetryOffered = false; // the retry dialog is open or about to be
+  void offerAuthorizationRetry();
+
+  StartupPipeline* startup; // runs the startup steps concurrently and times them
+  void addStartupSteps();
+
+  ArtworkDownloader* artworkDownloader;
+  map<string, vector<QPushButton*>> rowsByArtwork; // buttons of the merged playlist showing each cover url
+  void showMergedTracks(const string& accessToken, const vector<Track>& tracks);
+  void mergeFailed();
+  void writeFailed(size_t added, size_t total);
+  set<string> loadedArtwork; // cover urls whose rows already have their icon
+  string nowPlayingArtwork; // cover url of the current track
+
+  // counters of the now playing refresh, printed on exit
+  QElapsedTimer nowPlayingClock;
+  size_t nowPlayingChanges = 0;
+  qint64 nowPlayingUpdateNs = 0; // GUI thread time spent showing snapshots
+  string getNowPlayingReport() const;
   
   // Main menu (playlist page):
   void setUpContextMenu();
@@ -92,13 +149,23 @@ private:
   QPushButton* sharePlaylist;
   QPushButton* playPlaylist;
   QSlider* volumeSlider;
+  VolumeController* volumeController; // sends the slider value, latest wins, and reconciles it with the device
+  void showVolume(int percent);
 
 protected:
+  void changeEvent(QEvent *event) override;
   void closeEvent(QCloseEvent *event) override {
-    QDir directory("externals/images");
-    QStringList images = directory.entryList(QStringList() << "*.png", QDir::Files);
-    foreach(const QString &image, images){
-      directory.remove(image);
+    if (diagnostics) {
+      cout << spotifyApi.getConnectionStats() << endl;
+      cout << spotifyApi.getCacheStats() << endl;
+      cout << spotifyApi.getResponseCacheStats() << endl;
+      cout << spotifyApi.getTokenStats() << endl;
+      cout << artworkDownloader->getStatsReport() << endl;
+      cout << getNowPlayingReport() << endl;
+      cout << frameMonitor->getReport() << endl;
+      cout << volumeController->getStatsReport() << endl;
+      cout << playbackCommands->getStatsReport() << endl;
+      cout << deviceRegistry->getStatsReport() << endl;
     }
     event->accept();
   }
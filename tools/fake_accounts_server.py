@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Stand-in for the Spotify accounts service, to try the authorization flow without a Spotify account.
+
+Start it, then start the application pointed at it:
+
+    python3 tools/fake_accounts_server.py [--reject-refresh]
+    SPOTIFY_ACCOUNTS_URL=http://127.0.0.1:8767 ./Application
+
+GET /authorize redirects straight back to the redirect_uri with the code "good-code", as if the user had
+accepted. POST /api/token answers the three grants the application sends:
+  authorization_code  a user token, if the code is "good-code" and the redirect_uri matches
+  refresh_token       a new user token, without a new refresh token, or with --reject-refresh the
+                      400 invalid_grant of a revoked refresh token, which sends the application back
+                      through authorization
+  client_credentials  a client token
+Any other code gets the 400 invalid_grant the real service sends. Only the accounts service is faked, calls
+to the Web API still go to api.spotify.com and fail with the fake tokens.
+"""
+
+import http.server
+import json
+import sys
+import urllib.parse
+
+PORT = 8767
+GOOD_CODE = "good-code"
+reject_refresh = "--reject-refresh" in sys.argv[1:]
+
+redirect_uris = set()  # redirect_uri of every /authorize request, a code is only exchanged for one of them
+
+
+class AccountsHandler(http.server.BaseHTTPRequestHandler):
+    def do_GET(self):
+        url = urllib.parse.urlparse(self.path)
+        if url.path != "/authorize":
+            self.send_error(404)
+            return
+        query = urllib.parse.parse_qs(url.query)
+        redirect_uri = query.get("redirect_uri", [""])[0]
+        redirect_uris.add(redirect_uri)
+        answer = {"code": GOOD_CODE}
+        if "state" in query:
+            answer["state"] = query["state"][0]
+        self.send_response(302)
+        self.send_header("Location", redirect_uri + "?" + urllib.parse.urlencode(answer))
+        self.send_header("Content-Length", "0")
+        self.end_headers()
+        log("authorize", 302)
+
+    def do_POST(self):
+        if urllib.parse.urlparse(self.path).path != "/api/token":
+            self.send_error(404)
+            return
+        length = int(self.headers.get("Content-Length", 0))
+        form = urllib.parse.parse_qs(self.rfile.read(length).decode())
+        grant = form.get("grant_type", [""])[0]
+        if grant == "authorization_code":
+            accepted = (form.get("code", [""])[0] == GOOD_CODE
+                        and form.get("redirect_uri", [""])[0] in redirect_uris)
+            if accepted:
+                self.answer(200, {"access_token": "fake-user-token", "refresh_token": "fake-refresh-token",
+                                  "expires_in": 3600})
+            else:
+                self.answer(400, {"error": "invalid_grant", "error_description": "Invalid authorization code"})
+        elif grant == "refresh_token":
+            if reject_refresh:
+                self.answer(400, {"error": "invalid_grant", "error_description": "Refresh token revoked"})
+            else:
+                self.answer(200, {"access_token": "fake-refreshed-token", "expires_in": 3600})
+        elif grant == "client_credentials":
+            self.answer(200, {"access_token": "fake-client-token", "expires_in": 3600})
+        else:
+            self.answer(400, {"error": "unsupported_grant_type"})
+        log(grant, self.status)
+
+    def answer(self, status, body):
+        data = json.dumps(body).encode()
+        self.status = status
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def log_message(self, *args):
+        pass
+
+
+def log(request, status):
+    print(request, status, flush=True)
+
+
+if __name__ == "__main__":
+    print("Fake accounts service on http://127.0.0.1:%d" % PORT, file=sys.stderr)
+    http.server.HTTPServer(("127.0.0.1", PORT), AccountsHandler).serve_forever()